@@ -1,5 +1,7 @@
+#include<algorithm>
 #include<chrono>
 #include<cstdint>
+#include<exception>
 #include<functional>
 #include<iostream>
 #include<limits>
@@ -10,6 +12,7 @@
 
 #include "GraphGen.hpp"
 #include "GraphIo.hpp"
+#include "GraphUtils.hpp"
 
 enum Output {
     GRAPHVIZ_GRAPH_PARTITION,
@@ -17,7 +20,13 @@ enum Output {
     GRAPH,
     TIME,
     CUT_COST,
-    GRAPHVIZ_GRAPH
+    GRAPHVIZ_GRAPH,
+    ENSEMBLE_STATS,
+    GRAPH_BINARY,
+    REFINE_STATS,
+    CUT_STATS,
+    BEAM_GAP,
+    IMBALANCE
 };
 
 enum OutputMod {
@@ -30,13 +39,19 @@ enum PartMethods {
     TREE_PARTITION,
     METIS_KWAY,
     METIS_REC,
-    KAFFPA
+    KAFFPA,
+    RST_ENSEMBLE,
+    MULTILEVEL
 };
 
 struct Result {
     std::string method_name;
     graph::PartitionResult<int32_t, int32_t> part_result;
     std::chrono::milliseconds time_elapsed;
+    std::vector<graph::EnsembleTreeStats<int32_t>> ensemble_stats;
+    std::vector<graph::RefineRound<int32_t>> refine_rounds;
+    std::vector<cut::CutStatistics> cut_stats;
+    std::vector<std::pair<int32_t, int32_t>> beam_costs;
 
     Result() = default;
 
@@ -74,13 +89,48 @@ void run(
         std::vector<Output> output,
         OutputMod output_mod,
         size_t seed,
-        size_t tries
+        size_t tries,
+        size_t ensemble_size,
+        int32_t coarse_node_cnt,
+        size_t auto_root_cnt,
+        std::string cut_bound,
+        size_t beam_width,
+        int32_t weight_granularity,
+        int32_t scale_to,
+        std::chrono::milliseconds refine_time,
+        size_t thread_cnt
         ) {
 
     if (part_methods.size() > 0 && kparts == 0) {
         throw args::ValidationError(
                 "kparts is required if a partition method is applied.");
     }
+    if ((!cut_bound.empty() ? 1 : 0) + (weight_granularity > 1 ? 1 : 0) + (scale_to > 0 ? 1 : 0) > 1) {
+        throw args::ValidationError(
+                "Only one of cut_bound, weight_granularity and scale_to can be used.");
+    }
+    if (beam_width > 0 && (!cut_bound.empty() || weight_granularity > 1 || scale_to > 0)) {
+        throw args::ValidationError(
+                "beam_width can not be combined with cut_bound, weight_granularity or scale_to.");
+    }
+    bool const greedy_bound = cut_bound == "greedy";
+    bool const report_beam_gap = beam_width > 0 && auto_root_cnt == 0 &&
+        std::find(output.cbegin(), output.cend(), BEAM_GAP) != output.cend();
+    int32_t max_cut_cost = -1;
+    if (!cut_bound.empty() && !greedy_bound) {
+        size_t parsed_len = 0;
+        try {
+            max_cut_cost = std::stoi(cut_bound, &parsed_len);
+        } catch (std::exception const&) {
+            throw args::ValidationError("cut_bound must be a number or greedy.");
+        }
+        if (parsed_len != cut_bound.size()) {
+            throw args::ValidationError("cut_bound must be a number or greedy.");
+        }
+        if (max_cut_cost < 0) {
+            throw args::ValidationError("cut_bound must not be negative.");
+        }
+    }
 
     for (size_t graph_idx = 0; graph_idx < orig_graphs.size(); ++graph_idx) {
         for (size_t trie_idx = 0; trie_idx < tries; ++trie_idx) {
@@ -90,12 +140,41 @@ void run(
             for (auto method : part_methods) {
                 switch (method) {
                     case TREE_PARTITION:
-                        results.push_back(run_part_method(
-                                    "Tree_Partition",
-                                    [tree_part_graph, kparts, imbalance](){
-                                    return tree_part_graph.partition(kparts, imbalance);
-                                    })
-                                );
+                        {
+                            cut::CutStatistics cut_stats;
+                            results.push_back(run_part_method(
+                                        "Tree_Partition",
+                                        [tree_part_graph, kparts, imbalance, auto_root_cnt, greedy_bound, max_cut_cost,
+                                        beam_width, weight_granularity, scale_to, thread_cnt, &cut_stats](){
+                                        if (auto_root_cnt > 0) {
+                                            return tree_part_graph.partition_auto_root(kparts, imbalance,
+                                                    auto_root_cnt, thread_cnt);
+                                        } else if (greedy_bound) {
+                                            return tree_part_graph.partition_bounded(kparts, imbalance, 0, &cut_stats);
+                                        } else if (max_cut_cost >= 0) {
+                                            return tree_part_graph.partition_with_bound(kparts, imbalance,
+                                                    max_cut_cost, 0, &cut_stats);
+                                        } else if (weight_granularity > 1) {
+                                            return tree_part_graph.partition_coarsened(kparts, imbalance,
+                                                    weight_granularity, 0, &cut_stats);
+                                        } else if (scale_to > 0) {
+                                            auto result = tree_part_graph.partition_scaled(kparts, imbalance,
+                                                    scale_to, 0, &cut_stats);
+                                            graph::rebalance_partition(tree_part_graph, result, kparts, imbalance,
+                                                    thread_cnt);
+                                            return result;
+                                        }
+                                        return tree_part_graph.partition(kparts, imbalance, 0, &cut_stats, beam_width);
+                                        })
+                                    );
+                            if (auto_root_cnt == 0) {
+                                results.back().cut_stats.push_back(cut_stats);
+                            }
+                            if (report_beam_gap) {
+                                results.back().beam_costs.emplace_back(results.back().part_result.first,
+                                        tree_part_graph.partition(kparts, imbalance).first);
+                            }
+                        }
                         break;
                     case METIS_KWAY:
                         results.push_back(run_part_method(
@@ -121,6 +200,39 @@ void run(
                                     })
                                 );
                         break;
+                    case RST_ENSEMBLE:
+                        {
+                            graph::EnsembleResult<int32_t, int32_t> ensemble_res;
+                            results.push_back(run_part_method(
+                                        "RST_Ensemble",
+                                        [graph, kparts, imbalance, ensemble_size, seed, trie_idx, thread_cnt, &ensemble_res](){
+                                        ensemble_res = graph::partition_rst_ensemble(graph, kparts, imbalance,
+                                                ensemble_size, (seed + trie_idx) * ensemble_size, thread_cnt);
+                                        return ensemble_res.best;
+                                        })
+                                    );
+                            results.back().ensemble_stats = ensemble_res.tree_stats;
+                        }
+                        break;
+                    case MULTILEVEL:
+                        results.push_back(run_part_method(
+                                    "Multilevel",
+                                    [graph, kparts, imbalance, coarse_node_cnt, seed, trie_idx, thread_cnt](){
+                                    return graph::partition_multilevel(graph, kparts, imbalance,
+                                            coarse_node_cnt, seed + trie_idx, thread_cnt);
+                                    })
+                                );
+                        break;
+                }
+            }
+
+            if (refine_time.count() > 0) {
+                for (auto& result : results) {
+                    // Partitions of contracted graphs or decomposition trees do not belong to graph.
+                    if (result.part_result.second.size() == static_cast<size_t>(graph.node_cnt())) {
+                        result.refine_rounds = graph::refine_partition(
+                                graph, result.part_result, kparts, imbalance, refine_time, thread_cnt);
+                    }
                 }
             }
 
@@ -168,6 +280,60 @@ void run(
                         }
                         std::cout << std::endl;
                         break;
+                    case ENSEMBLE_STATS:
+                        for (auto const& result : results) {
+                            for (auto const& stats : result.ensemble_stats) {
+                                std::cout << stats.rst_seed << "\t" << stats.is_feasible << "\t";
+                                std::cout << stats.tree_cut_cost << "\t" << stats.graph_cut_cost << "\t";
+                                std::cout << stats.time_elapsed.count() << "\n";
+                            }
+                        }
+                        std::cout << std::endl;
+                        break;
+                    case CUT_STATS:
+                        for (auto const& result : results) {
+                            for (auto const& stats : result.cut_stats) {
+                                std::cout << result.method_name << "\t" << stats.node_cnt << "\t";
+                                std::cout << stats.class_cnt << "\t" << stats.cache_hit_cnt << "\t";
+                                std::cout << stats.aggregated_leaf_cnt << "\t" << stats.cost_pruned_cnt << "\t";
+                                std::cout << stats.packing_pruned_cnt << "\t" << stats.beam_dropped_cnt << "\n";
+                            }
+                        }
+                        std::cout << std::endl;
+                        break;
+                    case BEAM_GAP:
+                        for (auto const& result : results) {
+                            for (auto const& costs : result.beam_costs) {
+                                std::cout << result.method_name << "\t" << costs.first << "\t" << costs.second << "\t";
+                                std::cout << (costs.second > 0 ?
+                                        static_cast<double>(costs.first - costs.second) / costs.second : 0.0) << "\n";
+                            }
+                        }
+                        std::cout << std::endl;
+                        break;
+                    case IMBALANCE:
+                        for (auto const& result : results) {
+                            graph::Graph<> const& part_graph =
+                                (result.method_name == "Tree_Partition") ? tree_part_graph : graph;
+                            if (result.part_result.second.size() == static_cast<size_t>(part_graph.node_cnt())) {
+                                std::cout << part_graph.partition_imbalance(result.part_result.second, kparts).get_d();
+                            } else {
+                                std::cout << "-";
+                            }
+                            std::cout << "\t";
+                        }
+                        std::cout << std::endl;
+                        break;
+                    case REFINE_STATS:
+                        for (auto const& result : results) {
+                            for (auto const& round : result.refine_rounds) {
+                                std::cout << result.method_name << "\t" << round.pass << "\t";
+                                std::cout << round.cut_before << "\t" << round.cut_after << "\t";
+                                std::cout << round.move_cnt << "\t" << round.time_elapsed.count() << "\n";
+                            }
+                        }
+                        std::cout << std::endl;
+                        break;
                     case GRAPH:
                         if (output_mod != OutputMod::TREE) {
                             std::cout << graph;
@@ -178,6 +344,15 @@ void run(
                             std::cout << std::endl;
                         }
                         break;
+                    case GRAPH_BINARY:
+                        if (output_mod != OutputMod::TREE) {
+                            std::cout << graphio::WriteBinaryFormat<>(graph);
+                        }
+                        if (output_mod != OutputMod::ORIG_GRAPH) {
+                            std::cout << graphio::WriteBinaryFormat<>(tree_part_graph);
+                        }
+                        std::cout.flush();
+                        break;
                 }
             }
         }
@@ -206,6 +381,8 @@ int main(int argc, char** argv) {
             {"METIS_Kway", PartMethods::METIS_KWAY},
             {"METIS_Recursive", PartMethods::METIS_REC},
             {"KaFFPa", PartMethods::KAFFPA},
+            {"RST_Ensemble", PartMethods::RST_ENSEMBLE},
+            {"Multilevel", PartMethods::MULTILEVEL},
             });
     std::string part_method_options("OPTIONS:");
     for (auto const& option : part_method_map) {
@@ -225,7 +402,13 @@ int main(int argc, char** argv) {
             {"time", Output::TIME},
             {"cut_cost", Output::CUT_COST},
             {"graphviz_graph", Output::GRAPHVIZ_GRAPH},
-            {"graph", Output::GRAPH}
+            {"graph", Output::GRAPH},
+            {"graph_binary", Output::GRAPH_BINARY},
+            {"ensemble_stats", Output::ENSEMBLE_STATS},
+            {"refine_stats", Output::REFINE_STATS},
+            {"cut_stats", Output::CUT_STATS},
+            {"beam_gap", Output::BEAM_GAP},
+            {"imbalance", Output::IMBALANCE}
             });
     args::MapFlagList<std::string, Output> output(
             parser, "output", "Data to ouput. " + option_string(output_map),
@@ -325,13 +508,17 @@ int main(int argc, char** argv) {
         MST,
         RST,
         CONTRACT,
-        CONTRACT_INF
+        CONTRACT_INF,
+        DECOMPOSE,
+        FRT
     };
     std::unordered_map<std::string, Prep> prep_map({
             {"mst", Prep::MST},
             {"rst", Prep::RST},
             {"contract", Prep::CONTRACT},
-            {"contract_inf", Prep::CONTRACT_INF}
+            {"contract_inf", Prep::CONTRACT_INF},
+            {"decompose", Prep::DECOMPOSE},
+            {"frt", Prep::FRT}
             });
     args::MapFlagList<std::string, Prep> prep_list(
             prep_group, "Preprocessing", "Preprocessing step for tree partition. " + option_string(prep_map),
@@ -340,12 +527,57 @@ int main(int argc, char** argv) {
             prep_group, "Number of nodes to contract to",
             "Number of nodes to contract to when using contract preprocessing.",
             {"contract_to"});
+    args::ValueFlag<size_t> ensemble_size(
+            parser, "ensemble size",
+            "The number of random spanning trees partitioned by RST_Ensemble. DEFAULT: 8.",
+            {"ensemble_size"}, 8);
+    args::ValueFlag<int32_t> coarse_node_cnt(
+            parser, "coarse node count",
+            "The number of nodes of the coarsest graph of Multilevel. DEFAULT: 40.",
+            {"coarse_nodes"}, 40);
+    args::ValueFlag<size_t> auto_root_cnt(
+            parser, "auto root count",
+            "Select the root for Tree_Partition automatically and race this many of the most promising "
+            "roots in parallel. DEFAULT: 0 for root 0.",
+            {"auto_root"}, 0);
+    args::ValueFlag<std::string> cut_bound(
+            parser, "cut bound",
+            "Prune the signatures of Tree_Partition with an upper bound on the cut cost: either a number "
+            "or greedy for the cost of a greedy partition. Not used with --auto_root. Can not be combined with "
+            "--weight_granularity or --scale_to. DEFAULT: no bound.",
+            {"cut_bound"}, "");
+    args::ValueFlag<size_t> beam_width(
+            parser, "beam width",
+            "Keep at most this many signatures per frontier weight at each node in Tree_Partition. This is "
+            "faster but approximate. Output beam_gap compares the cost with the exact one. Can not be combined "
+            "with --cut_bound, --weight_granularity or --scale_to. DEFAULT: 0 for the exact cut.",
+            {"beam_width"}, 0);
+    args::ValueFlag<int32_t> weight_granularity(
+            parser, "weight granularity",
+            "Round the node weights up to multiples of this for Tree_Partition and tighten the imbalance "
+            "such that it still holds for the original weights. This is faster for large node weights "
+            "but approximate. Can not be combined with --scale_to. DEFAULT: 1 for the original weights.",
+            {"weight_granularity"}, 1);
+    args::ValueFlag<int32_t> scale_to(
+            parser, "scale to",
+            "Scale the node weights for Tree_Partition such that they add up to about this, solve the "
+            "scaled tree and repair the balance for the original weights. Output imbalance shows the "
+            "effective imbalance. DEFAULT: 0 for the original weights.",
+            {"scale_to"}, 0);
+    args::ValueFlag<int64_t> refine_time(
+            parser, "refine time",
+            "Refine the partitions of the graph with label propagation and FM for at most this many "
+            "milliseconds. The cut cost is then the cost on the graph. DEFAULT: 0 for no refinement.",
+            {"refine_time"}, 0);
+    args::ValueFlag<size_t> thread_cnt(
+            parser, "threads", "The number of threads to use. DEFAULT: all hardware threads.",
+            {"threads"}, 0);
 
 
     args::Group file_group(
             gen_or_files_group, "Use Input files", args::Group::Validators::AtLeastOne);
     args::ValueFlagList<std::string> file_list(
-            file_group, "files", "File for graph input or - for stdin.",
+            file_group, "files", "File for graph input or - for stdin. The METIS and the binary format are detected automatically.",
             {'f', "file"});
     args::ValueFlagList<std::string> tree_file_list(
             file_group, "tree files", "Read a tree from file. For every tree file there must be a graph file."
@@ -453,13 +685,13 @@ int main(int argc, char** argv) {
                     case MST:
                         for (auto& tree : tree_part_graphs) {
                             tree = std::shared_ptr<graphgen::IGraphGen<>>(
-                                    new graphgen::Mst<>(tree));
+                                    new graphgen::Mst<>(tree, args::get(thread_cnt)));
                         }
                         break;
                     case RST:
                         for (auto& tree : tree_part_graphs) {
                             tree = std::shared_ptr<graphgen::IGraphGen<>>(
-                                    new graphgen::Rst<>(tree));
+                                    new graphgen::Rst<>(tree, 0, args::get(thread_cnt)));
                         }
                         break;
                     case CONTRACT:
@@ -474,6 +706,18 @@ int main(int argc, char** argv) {
                                     new graphgen::ContractInfEdges<>(tree));
                         }
                         break;
+                    case DECOMPOSE:
+                        for (auto& tree : tree_part_graphs) {
+                            tree = std::shared_ptr<graphgen::IGraphGen<>>(
+                                    new graphgen::Decompose<>(tree, graph::Rational(1, 10), args::get(thread_cnt)));
+                        }
+                        break;
+                    case FRT:
+                        for (auto& tree : tree_part_graphs) {
+                            tree = std::shared_ptr<graphgen::IGraphGen<>>(
+                                    new graphgen::Frt<>(tree, 0, args::get(thread_cnt)));
+                        }
+                        break;
                 }
             }
         }
@@ -487,7 +731,16 @@ int main(int argc, char** argv) {
                 args::get(output),
                 args::get(output_mod),
                 args::get(seed),
-                args::get(tries)
+                args::get(tries),
+                args::get(ensemble_size),
+                args::get(coarse_node_cnt),
+                args::get(auto_root_cnt),
+                args::get(cut_bound),
+                args::get(beam_width),
+                args::get(weight_granularity),
+                args::get(scale_to),
+                std::chrono::milliseconds(args::get(refine_time)),
+                args::get(thread_cnt)
            );
     }
     catch (args::Help)
@@ -0,0 +1,138 @@
+#include<cstdint>
+#include<fstream>
+#include<iostream>
+#include<memory>
+#include<string>
+
+#include<args.hxx>
+
+#include "Partition.hpp"
+#include "Pipeline.hpp"
+
+int main(int argc, char** argv) {
+    args::ArgumentParser parser(
+            "Partition a graph given as SNAP edge list by contracting it, decomposing it into a tree "
+            "and partitioning the tree. All stages run in this process.",
+            "Lukas Stevens"
+            );
+    args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
+    args::ValueFlag<std::string> file(
+            parser, "file", "The file with the edge list or - for stdin. Default: -.",
+            {'f', "file"}, "-");
+    args::Flag no_header(
+            parser, "no_header", "The first line contains an edge instead of the node and edge count.",
+            {"no_header"});
+    args::ValueFlag<int32_t> kparts(
+            parser, "kparts", "The number of parts to partition into.",
+            {'k', "kparts"}, 2);
+    args::ValueFlag<graph::Rational> imbalance(
+            parser, "imbalance", "The allowed imbalance of a partition: "
+            "each part has at most (1+imbalance)*ceil(node_count/kparts) nodes.",
+            {'i', "imbalance"},
+            graph::Rational(1,2)
+            );
+    args::ValueFlag<int32_t> contract_to(
+            parser, "contract_to", "The number of nodes to contract to before the decomposition. "
+            "Default: 0 for no contraction.",
+            {"contract_to"}, 0);
+    args::ValueFlag<size_t> seed(
+            parser, "seed", "The seed for the contraction. Default: 0.",
+            {'s', "seed"}, 0);
+    args::ValueFlag<graph::Rational> bisection_imbalance(
+            parser, "bisection_imbalance", "The allowed imbalance of each bisection of the decomposition. "
+            "Default: 1/10.",
+            {"bisection_imbalance"}, graph::Rational(1, 10));
+    args::ValueFlag<std::string> hdecomp_jar(
+            parser, "hdecomp_jar", "Use the jar of the hierarchical decomposition at this path instead of "
+            "the recursive bisection.",
+            {"hdecomp_jar"});
+    args::ValueFlag<std::string> hdecomp_args(
+            parser, "hdecomp_args", "Additional arguments for the jar of the hierarchical decomposition.",
+            {"hdecomp_args"}, "");
+    args::ValueFlag<std::string> tmp_dir(
+            parser, "tmp_dir", "The directory for temporary files. Default: /tmp.",
+            {"tmp_dir"}, "/tmp");
+    args::ValueFlag<size_t> thread_cnt(
+            parser, "threads", "The number of threads to use. DEFAULT: all hardware threads.",
+            {"threads"}, 0);
+    args::ValueFlag<std::string> partition_file(
+            parser, "partition_file", "Write the part of each node, one per line, to this file.",
+            {"write_partition"});
+    args::ValueFlag<std::string> graph_file(
+            parser, "graph_file", "Write the input graph in the METIS format to this file.",
+            {"write_graph"});
+    args::ValueFlag<std::string> contracted_file(
+            parser, "contracted_file", "Write the contracted graph in the METIS format to this file.",
+            {"write_contracted"});
+    args::ValueFlag<std::string> decomposed_file(
+            parser, "decomposed_file", "Write the decomposition tree in the METIS format to this file.",
+            {"write_decomposed"});
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (args::Help) {
+        std::cout << parser;
+        return 0;
+    } catch (args::ParseError e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    pipeline::PipelineOptions<> options(args::get(kparts), args::get(imbalance), args::get(contract_to));
+    options.has_header = !args::get(no_header);
+    options.seed = args::get(seed);
+    options.thread_cnt = args::get(thread_cnt);
+    options.graph_file = args::get(graph_file);
+    options.contracted_file = args::get(contracted_file);
+    options.decomposed_file = args::get(decomposed_file);
+    std::shared_ptr<pipeline::IDecomposer<>> decomposer;
+    if (hdecomp_jar) {
+        decomposer = std::make_shared<pipeline::JarDecomposer<>>(
+                args::get(hdecomp_jar), args::get(hdecomp_args), args::get(tmp_dir), args::get(thread_cnt));
+    } else {
+        decomposer = std::make_shared<pipeline::BisectionDecomposer<>>(
+                args::get(bisection_imbalance), args::get(thread_cnt));
+    }
+    pipeline::Pipeline<> run_pipeline(options, decomposer);
+
+    pipeline::PipelineResult<> result;
+    try {
+        if (args::get(file) == "-") {
+            result = run_pipeline(std::cin);
+        } else {
+            std::ifstream input(args::get(file));
+            if (!input) {
+                std::cerr << "Opening " << args::get(file) << " failed." << std::endl;
+                return 1;
+            }
+            result = run_pipeline(input);
+        }
+    } catch (part::PartitionException const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (partition_file) {
+        std::ofstream output(args::get(partition_file));
+        for (auto const part : result.partition) {
+            output << part << "\n";
+        }
+    }
+
+    std::cout << "nodes: " << result.node_cnt << "\n";
+    std::cout << "contracted nodes: " << result.contracted_node_cnt << "\n";
+    std::cout << "decomposition nodes: " << result.decomposed_node_cnt << "\n";
+    std::cout << "tree cut cost: " << result.tree_cut_cost << "\n";
+    std::cout << "cut cost: " << result.cut_cost << "\n";
+    std::cout << "max part weight: " << result.max_part_weight << "\n";
+    std::cout << "total weight: " << result.total_weight << "\n";
+    for (auto const& timing : result.timings) {
+        std::cout << "time " << timing.stage << " (ms): " << timing.time_elapsed.count() << "\n";
+    }
+    std::cout << std::flush;
+}
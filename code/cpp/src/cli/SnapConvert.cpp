@@ -1,11 +1,71 @@
+#include<chrono>
+#include<cstdint>
 #include<iostream>
+#include<string>
 
-#include "GraphIo.hpp"
+#include<sys/resource.h>
 
-int main(int argc, char** args) {
-    graph::Graph<> graph;
-    graphio::ReadSnapFormat<> read(graph);
-    std::cin >> read;
-    std::cout << graph;
+#include<args.hxx>
+
+#include "SnapConvert.hpp"
+
+/**
+ * Get the peak resident set size of this process.
+ * @returns The peak resident set size in KiB.
+ */
+long peak_rss_kib() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
 }
 
+int main(int argc, char** argv) {
+    args::ArgumentParser parser(
+            "Convert an edge list in the SNAP format from stdin into a graph on stdout.",
+            "Lukas Stevens"
+            );
+    args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
+    args::ValueFlag<size_t> memory_mib(
+            parser, "memory", "The memory in MiB used for sorting the edges. Default: 1024.",
+            {"memory"}, 1024);
+    args::ValueFlag<std::string> tmp_dir(
+            parser, "tmp_dir", "The directory for temporary files. Default: /tmp.",
+            {"tmp_dir"}, "/tmp");
+    args::Flag no_header(
+            parser, "no_header", "The first line contains an edge instead of the node and edge count.",
+            {"no_header"});
+    args::Flag binary(
+            parser, "binary", "Write the binary graph format instead of the METIS format.",
+            {"binary"});
+    args::Flag stats(
+            parser, "stats", "Print the number of nodes and edges, the time and the peak memory to stderr.",
+            {"stats"});
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (args::Help) {
+        std::cout << parser;
+        return 0;
+    } catch (args::ParseError e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    graphio::SnapConvertOptions options(
+            args::get(memory_mib) << 20, args::get(tmp_dir), !args::get(no_header), args::get(binary));
+
+    auto const time_start = std::chrono::steady_clock::now();
+    graphio::SnapConvertStats const convert_stats = graphio::convert_snap_format<>(std::cin, std::cout, options);
+    std::chrono::duration<double> const time_elapsed = std::chrono::steady_clock::now() - time_start;
+
+    if (args::get(stats)) {
+        std::cerr << "input edges: " << convert_stats.input_edge_cnt << "\n";
+        std::cerr << "nodes: " << convert_stats.node_cnt << "\n";
+        std::cerr << "edges: " << convert_stats.edge_cnt << "\n";
+        std::cerr << "sorted runs: " << convert_stats.run_cnt << "\n";
+        std::cerr << "time (s): " << time_elapsed.count() << "\n";
+        std::cerr << "peak memory (KiB): " << peak_rss_kib() << std::endl;
+    }
+}
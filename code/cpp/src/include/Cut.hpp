@@ -1,12 +1,21 @@
 /** @file Cut.hpp */
 #pragma once
 
+#include<algorithm>
+#include<atomic>
 #include<cstdint>
+#include<cstring>
+#include<functional>
 #include<iostream>
+#include<limits>
 #include<list>
 #include<map>
+#include<memory>
 #include<set>
 #include<sstream>
+#include<stdexcept>
+#include<string>
+#include<tuple>
 #include<unordered_map>
 #include<unordered_set>
 #include<valarray>
@@ -14,6 +23,7 @@
 
 #include<gmpxx.h>
 
+#include "FileUtils.hpp"
 #include "GMPUtils.hpp"
 #include "ValarrayUtils.hpp"
 
@@ -72,13 +82,16 @@ namespace cut {
      * A type which saves the signatures at a node. 
      * It maps the number of nodes in the lower frontier to the possible 
      * signatures with this number of nodes and the signatures are mapped to their cut cost.
+     * Only the weights of the lower frontier which have at least one signature are stored, hence
+     * the memory and the iteration over the map depend on the occupied weights and not on the
+     * weight of the subtrees.
      * Since signatures are valarrays, we can use ValarrayHasher and ValarrayEqual.
      * @see ValarrayHasher
      * @see ValarrayEqual
      * @see Signature
      */
     template<typename NodeWeight, typename EdgeWeight>
-        using SignatureMap = std::vector<std::unordered_map<Signature<NodeWeight>, EdgeWeight, 
+        using SignatureMap = std::map<NodeWeight, std::unordered_map<Signature<NodeWeight>, EdgeWeight, 
               valarrutils::ValarrayHasher<NodeWeight>, valarrutils::ValarrayEqual<NodeWeight>>>;
 
     /**
@@ -127,9 +140,161 @@ namespace cut {
 
     using Rational = mpq_class; /**< The type of a rational. **/
 
+    /**
+     * Statistics of Tree::cut().
+     */
+    struct CutStatistics {
+        size_t node_cnt = 0; /**< The number of nodes whose signatures were determined. */
+        size_t class_cnt = 0; /**< The number of distinct classes of isomorphic forests. */
+        /**
+         * The number of nodes whose signatures were taken from the cache. These nodes share the cached
+         * signatures if CutOptions::delete_signatures is set, otherwise they hold a copy.
+         */
+        size_t cache_hit_cnt = 0;
+        size_t aggregated_leaf_cnt = 0; /**< The number of leaves which were folded in as part of a run. */
+        size_t cost_pruned_cnt = 0; /**< The number of signatures dropped since they exceeded the cut cost bound. */
+        size_t packing_pruned_cnt = 0; /**< The number of signatures dropped since they could not be packed. */
+        size_t beam_dropped_cnt = 0; /**< The number of signatures dropped since they were not in the beam. */
+    };
+
+    /**
+     * Options for Tree::cut().
+     */
+    struct CutOptions {
+        /**
+         * Indicates if the signatures at the nodes except the root should be deleted if they are
+         * not needed any more.
+         */
+        bool delete_signatures = false;
+        /**
+         * If this is set, Tree::cut() checks the flag before each node and stops with a
+         * CutCancelledException once it is true.
+         */
+        std::atomic<bool> const* cancel = nullptr;
+        /**
+         * Indicates if the signatures of isomorphic forests are calculated only once. Unless
+         * \ref delete_signatures is set, every node still holds its own copy of the signatures.
+         * @see Tree::forest_classes()
+         */
+        bool memoize_isomorphic = true;
+        /**
+         * If this is set, Tree::cut() stores its statistics there.
+         */
+        CutStatistics* statistics = nullptr;
+        /**
+         * Indicates if runs of adjacent leaf siblings are folded in at once, grouped by their node
+         * and edge weight. This only applies if \ref delete_signatures is set since the signatures
+         * inside a run are not calculated.
+         * @see Tree::cut_at_leaf_run()
+         */
+        bool aggregate_leaf_runs = true;
+        /**
+         * Indicates if a node without a left sibling or without a child takes over the signatures of
+         * its single predecessor instead of combining them with the 0-vector.
+         * @see Tree::cut_at_chain_node()
+         */
+        bool compress_chains = true;
+        /**
+         * An upper bound on the cut cost, e.g. the cost of a heuristic partition. Since the cut cost
+         * of a signature only increases towards the root, Tree::cut() drops every signature whose
+         * cut cost exceeds the bound. The signatures at the root which do not exceed the bound are
+         * exact. By default there is no bound.
+         */
+        double max_cut_cost = std::numeric_limits<double>::infinity();
+        /**
+         * Indicates if signatures whose components can not be packed into the parts any more are
+         * dropped. Such signatures are rejected by part::calculate_best_packing() anyway.
+         * @see SignaturePruning::is_unpackable()
+         */
+        bool prune_unpackable = false;
+        /**
+         * If this is greater than 0, Tree::cut() is approximate and keeps at most this many signatures
+         * per frontier weight at each node. The result at the root is still feasible but may be more
+         * expensive than the optimum. By default the cut is exact.
+         * @see Tree::truncate_to_beam()
+         */
+        size_t beam_width = 0;
+    };
+
+    /**
+     * This exception gets thrown if Tree::cut() was cancelled.
+     * @see CutOptions::cancel
+     */
+    struct CutCancelledException : public std::exception {
+        char const* what() const noexcept override {
+            return "The cut was cancelled.";
+        }
+    };
+
     template<typename Idtype, typename NodeWeight, typename EdgeWeight>
         struct SignaturesForTree;
 
+    /**
+     * The criteria by which Tree::cut() drops signatures before they reach the root.
+     * Cut costs and component counts never decrease towards the root, hence a dropped signature
+     * can not lead to a signature which is accepted at the root.
+     * It also counts the dropped signatures.
+     */
+    template<typename NodeWeight, typename EdgeWeight>
+        struct SignaturePruning {
+            public:
+                EdgeWeight const max_cut_cost; /**< Signatures with a higher cut cost are dropped. */
+                bool const prune_unpackable; /**< Indicates if unpackable signatures are dropped. */
+                NodeWeight const part_cnt; /**< The number of parts. */
+                /** The capacity of a part when the components are packed by part::calculate_best_packing(). */
+                NodeWeight const part_capacity;
+                /** The weight with which the components of each class are packed. */
+                std::vector<NodeWeight> const comp_weights;
+                /** The maximum number of components of each class which fit into the parts. */
+                std::vector<NodeWeight> max_comp_cnts;
+                size_t cost_pruned_cnt = 0; /**< The number of signatures dropped because of their cut cost. */
+                size_t packing_pruned_cnt = 0; /**< The number of signatures dropped because they can not be packed. */
+
+                /**
+                 * Constructor.
+                 * @param max_cut_cost The maximum cut cost of a kept signature.
+                 * @param prune_unpackable Indicates if unpackable signatures are dropped.
+                 * @param lower_comp_weight_bounds The lower component size bounds(inclusive) of the classes.
+                 * @param part_cnt The number of parts.
+                 */
+                SignaturePruning(EdgeWeight max_cut_cost, bool prune_unpackable,
+                        std::vector<NodeWeight> const& lower_comp_weight_bounds, NodeWeight part_cnt);
+
+                /**
+                 * Checks if a cut cost exceeds the bound and counts it if so.
+                 * @param cut_cost The cut cost of a signature.
+                 * @returns True if the signature should be dropped.
+                 */
+                bool exceeds_cut_cost(EdgeWeight cut_cost) {
+                    if (cut_cost > this->max_cut_cost) {
+                        this->cost_pruned_cnt += 1;
+                        return true;
+                    }
+                    return false;
+                }
+
+                /**
+                 * Checks if the components of a signature can not be packed into the parts any more and
+                 * counts it if so. This uses three lower bounds for the number of parts: the number of
+                 * components of a class divided by how many of them fit into one part, the total weight
+                 * of the components divided by the part capacity and the number of components which are
+                 * heavier than half a part.
+                 * @param sig The signature.
+                 * @returns True if the signature should be dropped.
+                 */
+                bool is_unpackable(Signature<NodeWeight> const& sig);
+        };
+
+    /**
+     * The order of the children of a node in a Tree.
+     * Tree::cut() folds the signatures of the children from left to right, hence a heavy child
+     * on the left inflates the signatures of all its right siblings.
+     */
+    enum class ChildOrder {
+        BY_ID, /**< Order the children by their ids. */
+        BY_SUBTREE_WEIGHT /**< Order the children by the weight of their subtrees, lightest first. */
+    };
+
     /**
      * This class represents a tree. The nodes of a tree are arranged in levels.
      * The nodes contain the necessary information to determine the parent and the
@@ -165,12 +330,14 @@ namespace cut {
                  * @param tree The tree to use.
                  * @param node_weight The node weights of the tree.
                  * @param root_id The id of the root in the tree.
+                 * @param child_order The order of the children of each node (default ChildOrder::BY_ID).
                  * @returns The tree built from \p tree.
                  */
                 static Tree<Id, NodeWeight, EdgeWeight> build_tree(
                         std::map<Id, std::map<Id, EdgeWeight>> const& tree, 
                         std::map<Id, NodeWeight> const& node_weight, 
-                        Id root_id);
+                        Id root_id,
+                        ChildOrder child_order=ChildOrder::BY_ID);
 
                 /**
                  * Calculates the sizes of the subtrees in the tree.
@@ -178,6 +345,35 @@ namespace cut {
                  */
                 void calculate_subtree_weights();
 
+                /**
+                 * Coarsens the node weights of the tree to the given granularity.
+                 * The weight of each node is rounded up to the next multiple of \p granularity and then
+                 * divided by it. Hence all frontier weights and thereby the number of signature tables at
+                 * each node shrink by this factor during the cut. The coarsened tree has to be cut with the
+                 * imbalance from calculate_coarsened_imbalance() to obey the original imbalance.
+                 * @param granularity The granularity of the node weights.
+                 * @returns The tree with the coarsened node weights.
+                 *
+                 * @throws std::invalid_argument if \p granularity is not positive.
+                 * @see calculate_coarsened_imbalance()
+                 */
+                Tree<Id, NodeWeight, EdgeWeight> coarsen_weights(NodeWeight granularity) const;
+
+                /**
+                 * Scales the node weights of the tree by \p factor and rounds them to the nearest integer.
+                 * Positive weights are rounded to at least one, hence the weight of the scaled tree exceeds
+                 * the scaled weight of the tree by at most the number of nodes. This bounds the weight of
+                 * the tree and thereby the frontier weights during the cut, but unlike coarsen_weights()
+                 * the parts of a partitioning of the scaled tree may be heavier than allowed by the
+                 * original weights.
+                 * @param factor The factor by which the node weights are scaled.
+                 * @returns The tree with the scaled node weights.
+                 *
+                 * @throws std::invalid_argument if \p factor is not positive.
+                 * @see graph::rebalance_partition()
+                 */
+                Tree<Id, NodeWeight, EdgeWeight> scale_weights(Rational factor) const;
+
 
                 /**
                  * Cuts the tree with the given parameters.
@@ -192,6 +388,40 @@ namespace cut {
                 SignaturesForTree<Id, NodeWeight, EdgeWeight> cut(Rational eps, NodeWeight part_cnt,
                         bool delete_signatures=false);
 
+                /**
+                 * Cuts the tree with the given parameters.
+                 * @param eps The approximation factor to use.
+                 * @param part_cnt The number of parts in which the tree should be partitioned.
+                 * @param options The options of the cut.
+                 * @returns The signatures calculated for the given parameters.
+                 *
+                 * @throws CutCancelledException if the cut was cancelled.
+                 * @see SignaturesForTree
+                 */
+                SignaturesForTree<Id, NodeWeight, EdgeWeight> cut(Rational eps, NodeWeight part_cnt,
+                        CutOptions const& options);
+
+                /**
+                 * Estimates the work of Tree::cut() for the current root.
+                 * The dynamic program combines the signatures of the left siblings of a node with the
+                 * signatures of its children and there is a map of signatures for each possible weight of
+                 * the lower frontier, hence the estimate is the sum of the products of these weights.
+                 * @returns The estimated work.
+                 */
+                double estimate_cut_work() const;
+
+                /**
+                 * Assigns each node except the root the class of the forest whose signatures are
+                 * calculated at the node, i.e. the subtrees rooted at the node and its left siblings.
+                 * Two nodes are in the same class iff their forests are equal with respect to shape,
+                 * node weights and edge weights, hence they have the same signatures. The class of a
+                 * node follows from the classes at its left sibling and right child, its weight and
+                 * the weight of its parent edge.
+                 * @returns The class of each node in the layout of Tree::levels. Classes start at one
+                 *  and the root has class zero.
+                 */
+                std::vector<std::vector<size_t>> forest_classes() const;
+
                 /**
                  * Calculates the signatures of the tree with information about the previous signatures.
                  * Additionally no signatures greater than \p signature are allowed.
@@ -217,6 +447,14 @@ namespace cut {
                 std::string as_graphviz() const;
 
             private:
+                /**
+                 * Copies the tree and replaces the weight of each node.
+                 * @param node_weight Maps the weight of a node to its new weight.
+                 * @returns The tree with the new node weights.
+                 */
+                Tree<Id, NodeWeight, EdgeWeight> with_node_weights(
+                        std::function<NodeWeight(NodeWeight)> const& node_weight) const;
+
                 /**
                  * Calculates the signatures at a node.
                  * Uses the signatures of the left sibling and the right child of the node.
@@ -224,19 +462,72 @@ namespace cut {
                  * which only contains one signature, namely the 0-vector, and which has cut cost 0.
                  * @param node The current node.
                  * @param node_subtree_weight The combined weight of the subree weighted at the current node.
-                 * @param left_siblings_weight The combined weight of the trees rooted at the siblings of \p node.
                  * @param left_sibling_sigs The signatures at the left sibling.
                  * @param right_child_sigs The signatures at the right child.
                  * @param comp_weight_bounds The upper component size bounds(exclusive) for the signature.
+                 * @param pruning The criteria by which signatures are dropped.
                  */
                 static SignatureMap cut_at_node(
                         Node const& node, 
                         NodeWeight node_subtree_weight,
-                        NodeWeight left_siblings_weight,
                         SignatureMap const& left_sibling_sigs, 
                         SignatureMap const& right_child_sigs, 
-                        std::vector<NodeWeight> const& comp_weight_bounds);
+                        std::vector<NodeWeight> const& comp_weight_bounds,
+                        SignaturePruning<NodeWeight, EdgeWeight>& pruning);
+
+
+                /**
+                 * Calculates the signatures at a node which has no left sibling or no child, e.g. a node
+                 * in a unary chain. The result is the same as the one of Tree::cut_at_node() with an empty
+                 * map for the missing node, but the signatures of the other node are taken over instead
+                 * of combining them with the 0-vector. Only the signatures with a cut parent edge are
+                 * added.
+                 * @param node The current node.
+                 * @param node_subtree_weight The combined weight of the subree weighted at the current node.
+                 * @param sigs The signatures at the right child or at the left sibling.
+                 * @param sigs_of_child Indicates whether \p sigs are the signatures of the right child.
+                 * @param comp_weight_bounds The upper component size bounds(exclusive) for the signature.
+                 * @param pruning The criteria by which signatures are dropped.
+                 */
+                static SignatureMap cut_at_chain_node(
+                        Node const& node,
+                        NodeWeight node_subtree_weight,
+                        SignatureMap sigs,
+                        bool sigs_of_child,
+                        std::vector<NodeWeight> const& comp_weight_bounds,
+                        SignaturePruning<NodeWeight, EdgeWeight>& pruning);
+
+                /**
+                 * Calculates the signatures at the last node of a run of adjacent leaves which share
+                 * their parent. The leaves are grouped by their weight and the weight of their parent
+                 * edge. Leaves of the same group are interchangeable, hence only the number of cut
+                 * leaves of a group matters and the group is folded in with one pass over the signatures
+                 * instead of one pass per leaf.
+                 * @param level The level which contains the run.
+                 * @param run_begin_idx The index of the first leaf of the run.
+                 * @param run_end_idx The index of the last leaf of the run.
+                 * @param sigs The signatures at the left sibling of the first leaf.
+                 * @param comp_weight_bounds The upper component size bounds(exclusive) for the signature.
+                 * @param pruning The criteria by which signatures are dropped.
+                 */
+                static SignatureMap cut_at_leaf_run(
+                        std::vector<Node> const& level,
+                        size_t run_begin_idx,
+                        size_t run_end_idx,
+                        SignatureMap sigs,
+                        std::vector<NodeWeight> const& comp_weight_bounds,
+                        SignaturePruning<NodeWeight, EdgeWeight>& pruning);
 
+                /**
+                 * Keeps at most \p beam_width signatures per frontier weight. The signatures of a weight are
+                 * grouped by the class of their heaviest component and the cheapest signatures of the
+                 * groups are kept in turns, hence the kept signatures are cheap but still differ in their
+                 * components.
+                 * @param sigs The signatures at a node.
+                 * @param beam_width The maximum number of signatures per frontier weight.
+                 * @returns The number of dropped signatures.
+                 */
+                static size_t truncate_to_beam(SignatureMap& sigs, size_t beam_width);
 
                 /**
                  * Calculates the signatures at a node.
@@ -262,11 +553,13 @@ namespace cut {
     /**
      * Populates a Tree with the values from the inputstream.
      * This uses the following format:
-     * The first line contains two integers \c n \c r.
+     * The first line contains two integers \c n \c r and optionally a third integer \c v.
      * \c n specifies the number of nodes in the tree whereas \c r specifies the id of the root.
      * <code>n-1</code> lines follow each containing three integers \c f \c t \c w. 
      * \c f and \c t describe an edge in the tree from \c f to \c t. 
      * The weight of the edge is specified by \c w.
+     * If \c v is not 0, \c n lines follow each containing two integers \c u \c x, which specify
+     * that the node \c u has weight \c x. Otherwise all nodes have weight 1.
      * @param is The inputstream.
      * @param tree The tree to build populate.
      * @returns The inputstream.
@@ -310,6 +603,136 @@ namespace cut {
         std::vector<NodeWeight> calculate_lower_component_weight_bounds(
                 Rational eps, NodeWeight tree_weight, NodeWeight part_cnt);
 
+    /**
+     * Calculates the imbalance with which a tree whose node weights were coarsened to \p granularity
+     * has to be cut such that the partitioning obeys \p eps for the original node weights.
+     * Rounding up a node weight adds less than \p granularity, so the bound on the weight of a part
+     * is loosened by at most \p granularity times (\p node_cnt + \p part_cnt). This error is
+     * absorbed by tightening the imbalance accordingly.
+     * @param eps The desired imbalance for the original node weights.
+     * @param tree_weight The combined weight of all nodes in the original tree.
+     * @param node_cnt The number of nodes in the tree.
+     * @param part_cnt The number of parts in which the tree should be partitioned.
+     * @param granularity The granularity of the coarsened node weights.
+     * @returns The imbalance for the coarsened tree.
+     *
+     * @throws std::invalid_argument if \p granularity is too coarse for \p eps.
+     * @see Tree::coarsen_weights()
+     */
+    template<typename NodeWeight>
+        Rational calculate_coarsened_imbalance(Rational eps, NodeWeight tree_weight, NodeWeight node_cnt,
+                NodeWeight part_cnt, NodeWeight granularity);
+
+    /**
+     * The magic bytes at the start of a signature table in the binary format.
+     */
+    static char const SIGNATURE_TABLE_MAGIC[8] = {'\x89', 'S', 'I', 'G', 'T', 'A', 'B', 'L'};
+
+    /**
+     * The magic bytes at the end of a signature table in the binary format.
+     */
+    static char const SIGNATURE_INDEX_MAGIC[8] = {'S', 'I', 'G', 'I', 'N', 'D', 'E', 'X'};
+
+    /**
+     * The header of a signature table in the binary format. \n
+     * The header is followed by the approximation parameter as a string of \c eps_size characters
+     * which is padded with zeros to a multiple of eight bytes. \n
+     * Afterwards one chunk for each node of the tree follows in level order. A chunk starts with its size
+     * in bytes as uint64_t followed by the values id, number of lower frontier sizes, number of non-empty
+     * lower frontier sizes and for each non-empty lower frontier size the size, the number of signatures
+     * and the signatures each followed by its cut cost. \n
+     * Values are stored as int64_t. If the table is compressed, values are stored as zigzag encoded
+     * variable length integers instead and each signature is stored as difference to the previous
+     * signature with the same lower frontier size. \n
+     * The chunks are followed by the index which contains the id and the offset of the chunk of each node
+     * as int64_t and uint64_t. The file ends with the offset of the index as uint64_t and 
+     * SIGNATURE_INDEX_MAGIC. The index allows to read the signatures of a single node without reading the 
+     * whole table.
+     * @see SignatureTableFile
+     */
+    struct SignatureTableHeader {
+        char magic[8]; /**< Always SIGNATURE_TABLE_MAGIC. */
+        uint32_t version; /**< The version of the format. */
+        uint32_t is_compressed; /**< Indicates whether the values are compressed. */
+        uint32_t id_size; /**< The size of an id in bytes. */
+        uint32_t node_weight_size; /**< The size of a node weight in bytes. */
+        uint32_t edge_weight_size; /**< The size of an edge weight in bytes. */
+        uint32_t signature_length; /**< The length of a signature. */
+        uint64_t node_cnt; /**< The number of nodes and therefore chunks. */
+        int64_t part_cnt; /**< The number of parts in the partition. */
+        uint64_t eps_size; /**< The length of the approximation parameter as string. */
+    };
+
+    /**
+     * The version of the binary signature table format which is written.
+     */
+    static uint32_t const SIGNATURE_TABLE_VERSION = 1;
+
+    /**
+     * A signature table in the binary format which is mapped into memory.
+     * The signatures of a node are only decoded when requested.
+     * @see SignatureTableHeader
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        struct SignatureTableFile {
+            public:
+                using SignatureMap = SignatureMap<NodeWeight, EdgeWeight>; /**< The type to save the signatures at a node. */
+
+                /**
+                 * Map the signature table \p filename into memory and read its header and index.
+                 * @param filename The name of the file.
+                 *
+                 * @throws std::runtime_error if the file can not be mapped or is not a valid signature table
+                 *  for the given types.
+                 */
+                explicit SignatureTableFile(std::string const& filename);
+
+                /**
+                 * Getter for the number of parts.
+                 * @returns The number of parts in the partition.
+                 */
+                NodeWeight part_cnt() const { return static_cast<NodeWeight>(this->header.part_cnt); }
+
+                /**
+                 * Getter for the approximation parameter.
+                 * @returns The approximation parameter.
+                 */
+                Rational eps() const { return this->stored_eps; }
+
+                /**
+                 * Getter for the number of nodes.
+                 * @returns The number of nodes in the table.
+                 */
+                size_t node_cnt() const { return static_cast<size_t>(this->header.node_cnt); }
+
+                /**
+                 * Getter for the length of a signature.
+                 * @returns The length of a signature.
+                 */
+                size_t signature_length() const { return static_cast<size_t>(this->header.signature_length); }
+
+                /**
+                 * Getter for the id of a node.
+                 * @param node_pos The position of the node in level order.
+                 * @returns The id of the node.
+                 */
+                Id node_id(size_t node_pos) const { return this->node_ids.at(node_pos); }
+
+                /**
+                 * Decodes the signatures of a single node.
+                 * @param node_pos The position of the node in level order.
+                 * @returns The signatures of the node.
+                 */
+                SignatureMap read_node_signatures(size_t node_pos) const;
+
+            private:
+                std::shared_ptr<fileutils::MappedFile> file; /**< The mapped file. */
+                SignatureTableHeader header; /**< The header of the table. */
+                Rational stored_eps; /**< The approximation parameter. */
+                std::vector<Id> node_ids; /**< The ids of the nodes in level order. */
+                std::vector<uint64_t> chunk_offsets; /**< The offsets of the chunks in level order. */
+        };
+
     /**
      * This class represents the signatures for a tree caclulated by Tree::cut(). 
      * The tree instance MUST outlive the SignaturesForTree instance.
@@ -340,6 +763,26 @@ namespace cut {
                     upper_comp_weight_bounds(calculate_upper_component_weight_bounds(eps, tree.subtree_weight[0][0], part_cnt)),
                     lower_comp_weight_bounds(calculate_lower_component_weight_bounds(eps, tree.subtree_weight[0][0], part_cnt)) {}
 
+                /**
+                 * Constructor for signatures which are loaded lazily from a signature table. 
+                 * The member signatures only contains empty maps, use node_signatures() to access the signatures.
+                 * @param tree The tree for which the signatures were calculated.
+                 * @param table_file The signature table.
+                 *
+                 * @throws std::invalid_argument if the table does not belong to \p tree.
+                 */
+                SignaturesForTree(Tree const& tree, std::shared_ptr<SignatureTableFile<Id, NodeWeight, EdgeWeight> const> table_file);
+
+                /**
+                 * Getter for the signatures at a node.
+                 * If the signatures were loaded from a signature table, the signatures of the node are decoded on the
+                 * first access and cached afterwards. This is not thread-safe.
+                 * @param lvl_idx The level of the node.
+                 * @param node_idx The index of the node in its level.
+                 * @returns The signatures at the node.
+                 */
+                SignatureMap const& node_signatures(size_t lvl_idx, size_t node_idx) const;
+
                 /** 
                  * A type representing the edges cut by the cutting phase.
                  */
@@ -361,6 +804,11 @@ namespace cut {
                 std::vector<std::map<Id, NodeWeight>>
                     components_for_cut_edges(CutEdges const& cut_edges) const;
 
+            private:
+                /** The signature table the signatures are loaded from or nullptr. */
+                std::shared_ptr<SignatureTableFile<Id, NodeWeight, EdgeWeight> const> table_file;
+                /** The signatures which were already loaded from the signature table. */
+                mutable std::map<std::pair<size_t, size_t>, SignatureMap> loaded_signatures;
         };
 
     /**
@@ -456,6 +904,59 @@ namespace cut {
      */
     template<typename Id, typename NodeWeight, typename EdgeWeight>
         std::istream& operator>>(std::istream& is, SignaturesForTreeBuilder<Id, NodeWeight, EdgeWeight>& builder);
+
+    /**
+     * Writer for signatures in the binary signature table format.
+     * @see SignatureTableHeader
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        struct WriteSignatureTable {
+            SignaturesForTree<Id, NodeWeight, EdgeWeight> const& signatures; /**< The signatures to write. */
+            bool do_compress; /**< Indicates whether the values should be compressed. */
+
+            /**
+             * Constructor.
+             * @param signatures The signatures to write.
+             * @param do_compress Indicates whether the values should be compressed. Default: true.
+             */
+            WriteSignatureTable(SignaturesForTree<Id, NodeWeight, EdgeWeight> const& signatures, bool do_compress=true) :
+                signatures(signatures), do_compress(do_compress) {}
+        };
+
+    /**
+     * Writes the signatures in the binary signature table format. 
+     * The output stream does not need to be seekable.
+     * @param os The outputstream.
+     * @param write The writer.
+     * @returns The outputstream.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::ostream& operator<<(std::ostream& os, WriteSignatureTable<Id, NodeWeight, EdgeWeight> const& write);
+
+    /**
+     * Reader for signatures in the binary signature table format.
+     * @see SignatureTableHeader
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        struct ReadSignatureTable {
+            SignaturesForTreeBuilder<Id, NodeWeight, EdgeWeight>& builder; /**< The builder to populate. */
+
+            /**
+             * Constructor.
+             * @param builder The builder to populate.
+             */
+            ReadSignatureTable(SignaturesForTreeBuilder<Id, NodeWeight, EdgeWeight>& builder) : builder(builder) {}
+        };
+
+    /**
+     * Populates a SignaturesForTreeBuilder with a signature table in the binary format.
+     * The chunks are read sequentially, hence the index is not used.
+     * @param is The inputstream.
+     * @param read The reader.
+     * @returns The inputstream.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::istream& operator>>(std::istream& is, ReadSignatureTable<Id, NodeWeight, EdgeWeight>& read);
 }
 
 // Include template implementation.
@@ -0,0 +1,339 @@
+/** @file FileUtils.hpp */
+#pragma once
+
+#include<cerrno>
+#include<cstdint>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+/**
+ * Contains utilities to access files.
+ */
+namespace fileutils {
+
+    /**
+     * A file which is mapped read-only into memory.
+     * The mapping is released when the object is destroyed.
+     */
+    struct MappedFile {
+        private:
+            char const* data; /**< The start of the mapping or nullptr for empty files. */
+            size_t length; /**< The size of the file in bytes. */
+
+            /**
+             * Throw an exception describing the last error of a system call.
+             * @param what The operation which failed.
+             * @param filename The file for which the operation failed.
+             */
+            [[noreturn]] static void throw_errno(std::string const& what, std::string const& filename) {
+                throw std::runtime_error(what + " " + filename + " failed: " + std::strerror(errno));
+            }
+
+        public:
+            /**
+             * Map the file \p filename into memory.
+             * @param filename The name of the file.
+             *
+             * @throws std::runtime_error if the file can not be opened or mapped or is not a regular file.
+             * @see is_regular_file()
+             */
+            explicit MappedFile(std::string const& filename) : data(nullptr), length(0) {
+                int const fd = ::open(filename.c_str(), O_RDONLY);
+                if (fd < 0) {
+                    throw_errno("Opening", filename);
+                }
+
+                struct stat file_stat;
+                if (::fstat(fd, &file_stat) != 0) {
+                    ::close(fd);
+                    throw_errno("Reading the size of", filename);
+                }
+                if (!S_ISREG(file_stat.st_mode)) {
+                    ::close(fd);
+                    throw std::runtime_error("Mapping " + filename + " failed: Not a regular file.");
+                }
+                this->length = static_cast<size_t>(file_stat.st_size);
+
+                if (this->length > 0) {
+                    void* mapping = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapping == MAP_FAILED) {
+                        ::close(fd);
+                        throw_errno("Mapping", filename);
+                    }
+                    ::madvise(mapping, this->length, MADV_SEQUENTIAL);
+                    this->data = static_cast<char const*>(mapping);
+                }
+                ::close(fd);
+            }
+
+            MappedFile(MappedFile const&) = delete;
+            MappedFile& operator=(MappedFile const&) = delete;
+
+            /**
+             * Destructor. Unmaps the file.
+             */
+            ~MappedFile() {
+                if (this->data != nullptr) {
+                    ::munmap(const_cast<char*>(this->data), this->length);
+                }
+            }
+
+            /**
+             * Getter for the start of the file.
+             * @returns A pointer to the first byte of the file.
+             */
+            char const* begin() const {
+                return this->data;
+            }
+
+            /**
+             * Getter for the end of the file.
+             * @returns A pointer past the last byte of the file.
+             */
+            char const* end() const {
+                return this->data + this->length;
+            }
+
+            /**
+             * Getter for the size of the file.
+             * @returns The size in bytes.
+             */
+            size_t size() const {
+                return this->length;
+            }
+    };
+
+    /**
+     * Checks whether \p filename is a regular file. Only regular files can be mapped into memory,
+     * pipes and other special files report no size.
+     * @param filename The name of the file.
+     * @returns True if the file exists and is a regular file.
+     */
+    inline bool is_regular_file(std::string const& filename) {
+        struct stat file_stat;
+        return ::stat(filename.c_str(), &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+    }
+
+    /**
+     * The size and the time of the last modification of a file.
+     */
+    struct FileStatus {
+        uint64_t size; /**< The size in bytes. */
+        int64_t mtime_sec; /**< The seconds of the time of the last modification. */
+        int64_t mtime_nsec; /**< The nanoseconds of the time of the last modification. */
+
+        /**
+         * Equality comparison.
+         * @param other The other status.
+         * @returns True if both the size and the modification time are equal.
+         */
+        bool operator==(FileStatus const& other) const {
+            return this->size == other.size && this->mtime_sec == other.mtime_sec &&
+                this->mtime_nsec == other.mtime_nsec;
+        }
+    };
+
+    /**
+     * Get the size and the time of the last modification of a file.
+     * @param filename The name of the file.
+     * @returns The status of the file.
+     *
+     * @throws std::runtime_error if the status can not be read.
+     */
+    inline FileStatus file_status(std::string const& filename) {
+        struct stat file_stat;
+        if (::stat(filename.c_str(), &file_stat) != 0) {
+            throw std::runtime_error("Reading the status of " + filename + " failed: " + std::strerror(errno));
+        }
+        FileStatus status;
+        status.size = static_cast<uint64_t>(file_stat.st_size);
+        status.mtime_sec = static_cast<int64_t>(file_stat.st_mtim.tv_sec);
+        status.mtime_nsec = static_cast<int64_t>(file_stat.st_mtim.tv_nsec);
+        return status;
+    }
+
+    /**
+     * An anonymous temporary file which is used for intermediate data.
+     * The file is removed from the directory right after its creation, hence it is
+     * deleted by the operating system once the object is destroyed.
+     */
+    struct TempFile {
+        private:
+            std::FILE* file; /**< The stream of the file. */
+
+        public:
+            /**
+             * Create a temporary file in directory \p dir.
+             * @param dir The directory for the file.
+             *
+             * @throws std::runtime_error if the file can not be created.
+             */
+            explicit TempFile(std::string const& dir) : file(nullptr) {
+                std::string path = dir + "/tmp_XXXXXX";
+                std::vector<char> path_buffer(path.cbegin(), path.cend());
+                path_buffer.push_back('\0');
+                int const fd = ::mkstemp(path_buffer.data());
+                if (fd < 0) {
+                    throw std::runtime_error("Creating a temporary file in " + dir + " failed: " + std::strerror(errno));
+                }
+                ::unlink(path_buffer.data());
+                this->file = ::fdopen(fd, "w+b");
+                if (this->file == nullptr) {
+                    ::close(fd);
+                    throw std::runtime_error("Opening a temporary file in " + dir + " failed: " + std::strerror(errno));
+                }
+            }
+
+            TempFile(TempFile const&) = delete;
+            TempFile& operator=(TempFile const&) = delete;
+
+            /**
+             * Destructor. Closes and thereby deletes the file.
+             */
+            ~TempFile() {
+                std::fclose(this->file);
+            }
+
+            /**
+             * Append data to the file.
+             * @param data The data.
+             * @param size The size of the data in bytes.
+             *
+             * @throws std::runtime_error if the data could not be written.
+             */
+            void write(void const* data, size_t size) {
+                if (size > 0 && std::fwrite(data, 1, size, this->file) != size) {
+                    throw std::runtime_error(std::string("Writing a temporary file failed: ") + std::strerror(errno));
+                }
+            }
+
+            /**
+             * Read data from the current position.
+             * @param data The buffer to read into.
+             * @param size The maximum number of bytes to read.
+             * @returns The number of bytes read. This is only less than \p size at the end of the file.
+             */
+            size_t read(void* data, size_t size) {
+                return std::fread(data, 1, size, this->file);
+            }
+
+            /**
+             * Move to the start of the file to read what was written.
+             */
+            void rewind() {
+                std::fflush(this->file);
+                std::rewind(this->file);
+            }
+    };
+
+    /**
+     * A temporary file with a name which can be passed to other processes.
+     * The file is created empty and removed once the object is destroyed.
+     */
+    struct NamedTempFile {
+        private:
+            std::string file_path; /**< The path of the file. */
+
+        public:
+            /**
+             * Create a temporary file in directory \p dir.
+             * @param dir The directory for the file.
+             *
+             * @throws std::runtime_error if the file can not be created.
+             */
+            explicit NamedTempFile(std::string const& dir) {
+                std::string path = dir + "/tmp_XXXXXX";
+                std::vector<char> path_buffer(path.cbegin(), path.cend());
+                path_buffer.push_back('\0');
+                int const fd = ::mkstemp(path_buffer.data());
+                if (fd < 0) {
+                    throw std::runtime_error("Creating a temporary file in " + dir + " failed: " + std::strerror(errno));
+                }
+                ::close(fd);
+                this->file_path = path_buffer.data();
+            }
+
+            NamedTempFile(NamedTempFile const&) = delete;
+            NamedTempFile& operator=(NamedTempFile const&) = delete;
+
+            /**
+             * Destructor. Removes the file.
+             */
+            ~NamedTempFile() {
+                ::unlink(this->file_path.c_str());
+            }
+
+            /**
+             * Getter for the path of the file.
+             * @returns The path.
+             */
+            std::string const& path() const {
+                return this->file_path;
+            }
+    };
+
+    /**
+     * Map a signed integer to an unsigned integer such that values with a small magnitude
+     * are mapped to small values.
+     * @param value The signed value.
+     * @returns The zigzag encoded value.
+     */
+    inline uint64_t zigzag_encode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /**
+     * Inverse of zigzag_encode().
+     * @param value The zigzag encoded value.
+     * @returns The signed value.
+     */
+    inline int64_t zigzag_decode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /**
+     * Write an unsigned integer as a variable length integer using seven bits per byte.
+     * @param os The output stream.
+     * @param value The value to write.
+     */
+    inline void write_varint(std::ostream& os, uint64_t value) {
+        while (value >= 0x80) {
+            os.put(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        os.put(static_cast<char>(value));
+    }
+
+    /**
+     * Read a variable length integer written by write_varint().
+     * @param pos The position to read from. It is moved past the integer.
+     * @param end The end of the buffer.
+     * @returns The value.
+     *
+     * @throws std::runtime_error if the integer is truncated or too long.
+     */
+    inline uint64_t read_varint(char const*& pos, char const* end) {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos == end) {
+                throw std::runtime_error("Truncated variable length integer.");
+            }
+            uint64_t const byte = static_cast<unsigned char>(*pos++);
+            value |= (byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Variable length integer is too long.");
+    }
+}
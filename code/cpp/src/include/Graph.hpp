@@ -2,19 +2,25 @@
 #pragma once
 
 #include<algorithm>
+#include<atomic>
 #include<cstdint>
+#include<exception>
+#include<functional>
+#include<future>
 #include<limits>
 #include<list>
 #include<set>
 #include<stdexcept>
 #include<string>
 #include<unordered_map>
+#include<utility>
 #include<vector>
 
 #include<metis.h>
 #include<kaHIP_interface.h>
 
 #include "Cut.hpp"
+#include "ParallelUtils.hpp"
 #include "Partition.hpp"
 
 /**
@@ -74,6 +80,29 @@ namespace graph {
                     adjwgt(adjwgt) {}
         };
 
+    /**
+     * A graph stored in the CSR format which keeps the id and weight types of Graph.
+     * In contrast to CsrGraph this is not meant to be passed to external libraries
+     * but is used by algorithms which scan all edges many times.
+     * Every undirected edge is stored in both directions.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        struct WeightedCsrGraph {
+            public:
+                std::vector<size_t> xadj;
+                std::vector<Id> adjncy;
+                std::vector<EdgeWeight> adjwgt;
+                std::vector<NodeWeight> vwgt;
+
+                /**
+                 * Getter for the node count of the graph.
+                 * @returns The number of nodes.
+                 */
+                Id node_cnt() const {
+                    return static_cast<Id>(this->vwgt.size());
+                }
+        };
+
     /**
      * CsrGraph for METIS.
      * @see CsrGraph
@@ -228,6 +257,28 @@ namespace graph {
                 std::vector<NodeSet> vrepr;
                 std::vector<NodeWeight> vwgt;
 
+                /**
+                 * Convert the signatures of a tree of this graph into the best partition.
+                 * @param signatures The signatures.
+                 * @returns The partitioning.
+                 *
+                 * @throws part::PartitionException if no signature can be packed.
+                 */
+                PartitionResult pack_signatures(
+                        cut::SignaturesForTree<Id, NodeWeight, EdgeWeight> const& signatures) const {
+                    std::vector<std::set<Id>> partitioning;
+                    typename cut::Tree<Id, NodeWeight, EdgeWeight>::Signature signature;
+                    EdgeWeight cut_cost;
+                    std::tie(partitioning, signature, cut_cost) = part::calculate_best_packing(signatures);
+                    std::vector<Id> partitioning_formatted(this->node_cnt());
+                    for (Id part_idx = 0; part_idx < partitioning.size(); ++part_idx) {
+                        for (auto const& node : partitioning[part_idx]) {
+                            partitioning_formatted.at(node) = part_idx;
+                        }
+                    }
+                    return std::make_pair(cut_cost, partitioning_formatted);
+                }
+
                 /**
                  * This constructor is only used internally.
                  * @param adjncy The graph.
@@ -265,6 +316,28 @@ namespace graph {
                         this->resize(node_cnt);
                     }
 
+                /**
+                 * Construct a graph from a graph in CSR format.
+                 * The adjacency of the nodes is built in parallel. Every edge must be stored
+                 * in both directions with the same weight.
+                 * @param csr_graph The graph in CSR format.
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+                 */
+                explicit Graph(WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph,
+                        size_t thread_cnt=0) :
+                    adjncy(csr_graph.vwgt.size()), vrepr(csr_graph.vwgt.size()), vwgt(csr_graph.vwgt)
+                {
+                    parutils::parallel_for(this->vwgt.size(), thread_cnt, [this, &csr_graph](size_t node){
+                            this->vrepr[node].insert(static_cast<Id>(node));
+                            auto& node_adjncy = this->adjncy[node];
+                            node_adjncy.reserve(csr_graph.xadj[node + 1] - csr_graph.xadj[node]);
+                            for (size_t edge_idx = csr_graph.xadj[node];
+                                    edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                                node_adjncy[csr_graph.adjncy[edge_idx]] = csr_graph.adjwgt[edge_idx];
+                            }
+                            });
+                }
+
                 /**
                  * Default constructor.
                  */
@@ -317,6 +390,24 @@ namespace graph {
                     return this->vrepr.at(node);
                 }
 
+                /**
+                 * Setter for the set of nodes a certain node represents.
+                 * @param node The node.
+                 * @param repr The set of nodes which \p node represents.
+                 */
+                void node_repr(Id node, NodeSet const& repr) {
+                    this->vrepr.at(node) = repr;
+                }
+
+                /**
+                 * Getter for the degree of a node.
+                 * @param node The node.
+                 * @returns The number of edges incident to \p node.
+                 */
+                Id degree(Id node) const {
+                    return static_cast<Id>(this->adjncy.at(node).size());
+                }
+
                 /**
                  * Checks if the given edge exists in the graph.
                  * Keep in mind that the graph is undirected.
@@ -471,6 +562,34 @@ namespace graph {
                         return CsrGraph<Idx>(metis_xadj, metis_adjncy, metis_vwgt, metis_adjwgt);
                     }
 
+                /**
+                 * Convert the graph to a WeightedCsrGraph.
+                 * The adjacency of the nodes is copied in parallel.
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+                 * @returns The graph in CSR format.
+                 */
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> to_weighted_csr_graph(
+                        size_t thread_cnt=0) const {
+                    WeightedCsrGraph<Id, NodeWeight, EdgeWeight> csr_graph;
+                    size_t const node_cnt = static_cast<size_t>(this->node_cnt());
+                    csr_graph.vwgt = this->vwgt;
+                    csr_graph.xadj.resize(node_cnt + 1);
+                    for (size_t node = 0; node < node_cnt; ++node) {
+                        csr_graph.xadj[node + 1] = csr_graph.xadj[node] + this->adjncy[node].size();
+                    }
+                    csr_graph.adjncy.resize(csr_graph.xadj.back());
+                    csr_graph.adjwgt.resize(csr_graph.xadj.back());
+                    parutils::parallel_for(node_cnt, thread_cnt, [this, &csr_graph](size_t node){
+                            size_t edge_idx = csr_graph.xadj[node];
+                            for (auto const& edge : this->adjncy[node]) {
+                                csr_graph.adjncy[edge_idx] = edge.first;
+                                csr_graph.adjwgt[edge_idx] = edge.second;
+                                edge_idx += 1;
+                            }
+                            });
+                    return csr_graph;
+                }
+
                 /**
                  * Convert a partition on the current graph into the real partition.
                  * This takes previous contractions into account.
@@ -578,11 +697,15 @@ namespace graph {
 
                 /**
                  * Converts the graph to a tree in the \p Tree format.
+                 * By default the children of each node are ordered by the weight of their subtrees,
+                 * lightest first, which keeps the signatures of the left siblings small during the cut.
                  * @param root The desired root (default 0).
+                 * @param child_order The order of the children (default cut::ChildOrder::BY_SUBTREE_WEIGHT).
                  * @returns The tree.
                  * @see cut::Tree
                  */
-                cut::Tree<Id, NodeWeight, EdgeWeight> to_tree(Id root=0) const {
+                cut::Tree<Id, NodeWeight, EdgeWeight> to_tree(Id root=0,
+                        cut::ChildOrder child_order=cut::ChildOrder::BY_SUBTREE_WEIGHT) const {
                     if (!this->is_tree()) {
                         throw std::logic_error("The graph is not a tree.");
                     }
@@ -594,7 +717,7 @@ namespace graph {
                         tree_map[node].insert(inc_edges.cbegin(), inc_edges.cend());
                         node_weight[node] = this->node_weight(node);
                     }
-                    return cut::Tree<Id, NodeWeight, EdgeWeight>::build_tree(tree_map, node_weight, root);
+                    return cut::Tree<Id, NodeWeight, EdgeWeight>::build_tree(tree_map, node_weight, root, child_order);
                 }
 
 
@@ -604,53 +727,574 @@ namespace graph {
                  * @param kparts The number of parts to partition into.
                  * @param imbalance The desired maximum imbalance of the partitioning.
                  * @param root The desired root (default 0).
+                 * @param statistics If this is set, the statistics of the cut are stored there (default nullptr).
+                 * @param beam_width If this is greater than 0, at most this many signatures are kept per
+                 *  frontier weight at each node. This bounds the time and memory, but the partitioning may be
+                 *  more expensive. If no signature in the beam can be packed, the exact cut is used
+                 *  (default 0 for the exact cut).
                  * @returns The partitioning.
                  * 
                  * @throws std::logic_error if the graph is not a tree.
                  * @see is_tree()
+                 * @see cut::CutOptions::beam_width
                  */
-                PartitionResult partition(Id kparts, Rational imbalance, Id root=0) const {
+                PartitionResult partition(Id kparts, Rational imbalance, Id root=0,
+                        cut::CutStatistics* statistics=nullptr, size_t beam_width=0) const {
                     cut::Tree<Id, NodeWeight, EdgeWeight> tree = this->to_tree(root);
-                    auto signatures = tree.cut(imbalance, kparts, true);
+                    cut::CutOptions options;
+                    options.delete_signatures = true;
+                    options.prune_unpackable = true;
+                    options.statistics = statistics;
+                    options.beam_width = beam_width;
+                    if (beam_width > 0) {
+                        try {
+                            auto signatures = tree.cut(imbalance, kparts, options);
+                            return this->pack_signatures(signatures);
+                        } catch (part::PartitionException const&) {
+                            options.beam_width = 0;
+                        }
+                    }
+                    auto signatures = tree.cut(imbalance, kparts, options);
+                    return this->pack_signatures(signatures);
+                }
 
-                    std::vector<std::set<Id>> partitioning;
-                    typename cut::Tree<Id, NodeWeight, EdgeWeight>::Signature signature;
-                    EdgeWeight cut_cost;
-                    std::tie(partitioning, signature, cut_cost) = part::calculate_best_packing(signatures);
-                    std::vector<Id> partitioning_formatted(this->node_cnt());
-                    for (Id part_idx = 0; part_idx < partitioning.size(); ++part_idx) {
-                        for (auto const& node : partitioning[part_idx]) {
-                            partitioning_formatted.at(node) = part_idx;
+                /**
+                 * Partition the graph using the method of Feldmann and Foschini on coarsened node weights.
+                 * The node weights are rounded up to multiples of \p granularity, which shrinks the
+                 * number of frontier weights at each node by this factor. The rounding error is absorbed
+                 * by cutting with a tighter imbalance, hence the partitioning still obeys \p imbalance
+                 * for the original node weights but may be more expensive than the one of partition().
+                 * This only works if the graph is a tree.
+                 * @param kparts The number of parts to partition into.
+                 * @param imbalance The desired maximum imbalance of the partitioning.
+                 * @param granularity The granularity of the node weights. For 1 this is the same as partition().
+                 * @param root The desired root (default 0).
+                 * @param statistics If this is set, the statistics of the cut are stored there (default nullptr).
+                 * @returns The partitioning.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 * @throws std::invalid_argument if \p granularity is too coarse for \p imbalance.
+                 * @see cut::Tree::coarsen_weights()
+                 * @see cut::calculate_coarsened_imbalance()
+                 */
+                PartitionResult partition_coarsened(Id kparts, Rational imbalance, NodeWeight granularity,
+                        Id root=0, cut::CutStatistics* statistics=nullptr) const {
+                    if (granularity <= 1) {
+                        return this->partition(kparts, imbalance, root, statistics);
+                    }
+
+                    cut::Tree<Id, NodeWeight, EdgeWeight> tree = this->to_tree(root);
+                    Rational const coarsened_imbalance = cut::calculate_coarsened_imbalance<NodeWeight>(
+                            imbalance, tree.subtree_weight[0][0], static_cast<NodeWeight>(this->node_cnt()),
+                            static_cast<NodeWeight>(kparts), granularity);
+                    cut::Tree<Id, NodeWeight, EdgeWeight> coarsened_tree = tree.coarsen_weights(granularity);
+                    cut::CutOptions options;
+                    options.delete_signatures = true;
+                    options.prune_unpackable = true;
+                    options.statistics = statistics;
+                    auto signatures = coarsened_tree.cut(coarsened_imbalance, kparts, options);
+                    return this->pack_signatures(signatures);
+                }
+
+                /**
+                 * Partition the graph using the method of Feldmann and Foschini on scaled node weights.
+                 * The node weights are scaled such that they add up to about \p target_weight and are
+                 * rounded to the nearest integer but not below one, hence the time and memory of the cut are
+                 * bounded by \p target_weight plus the number of nodes instead of the weight of the graph.
+                 * The partitioning obeys \p imbalance only for the scaled weights, use
+                 * graph::rebalance_partition() to repair the balance for the original weights and
+                 * partition_imbalance() to determine the effective imbalance.
+                 * This only works if the graph is a tree.
+                 * @param kparts The number of parts to partition into.
+                 * @param imbalance The desired maximum imbalance of the partitioning.
+                 * @param target_weight The weight of the scaled graph. If the graph is not heavier,
+                 *  this is the same as partition().
+                 * @param root The desired root (default 0).
+                 * @param statistics If this is set, the statistics of the cut are stored there (default nullptr).
+                 * @returns The partitioning.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 * @throws std::invalid_argument if \p target_weight is smaller than \p kparts.
+                 * @see cut::Tree::scale_weights()
+                 */
+                PartitionResult partition_scaled(Id kparts, Rational imbalance, NodeWeight target_weight,
+                        Id root=0, cut::CutStatistics* statistics=nullptr) const {
+                    if (target_weight < static_cast<NodeWeight>(kparts)) {
+                        throw std::invalid_argument("The target weight must not be smaller than the number of parts.");
+                    }
+
+                    cut::Tree<Id, NodeWeight, EdgeWeight> tree = this->to_tree(root);
+                    NodeWeight const tree_weight = tree.subtree_weight[0][0];
+                    if (tree_weight <= target_weight) {
+                        return this->partition(kparts, imbalance, root, statistics);
+                    }
+                    Rational scale(target_weight, tree_weight);
+                    scale.canonicalize();
+                    cut::Tree<Id, NodeWeight, EdgeWeight> scaled_tree = tree.scale_weights(scale);
+                    cut::CutOptions options;
+                    options.delete_signatures = true;
+                    options.prune_unpackable = true;
+                    options.statistics = statistics;
+                    auto signatures = scaled_tree.cut(imbalance, kparts, options);
+                    return this->pack_signatures(signatures);
+                }
+
+                /**
+                 * Partition the graph greedily. The tree is traversed bottom up and at each node the
+                 * components of the children are merged into the component of the node, lightest first,
+                 * as long as the component does not get heavier than a part may be. The remaining
+                 * children are cut off. Finally the components are packed first fit decreasing.
+                 * This is fast but gives no guarantee on the cut cost, hence it is mainly useful as
+                 * an upper bound for partition_bounded().
+                 * This only works if the graph is a tree.
+                 * @param kparts The number of parts to partition into.
+                 * @param imbalance The desired maximum imbalance of the partitioning.
+                 * @param root The desired root (default 0).
+                 * @returns The partitioning.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 * @throws part::PartitionException if the components do not fit into \p kparts parts.
+                 */
+                PartitionResult partition_greedy(Id kparts, Rational imbalance, Id root=0) const {
+                    size_t const node_cnt = this->vwgt.size();
+                    std::vector<Id> partitioning(node_cnt, 0);
+                    if (node_cnt == 0) {
+                        return std::make_pair(0, partitioning);
+                    }
+
+                    std::vector<Id> order(1, root);
+                    std::vector<Id> parent(node_cnt, -1);
+                    parent[static_cast<size_t>(root)] = root;
+                    for (size_t order_idx = 0; order_idx < order.size(); ++order_idx) {
+                        Id const node = order[order_idx];
+                        for (auto const& edge : this->adjncy[static_cast<size_t>(node)]) {
+                            if (parent[static_cast<size_t>(edge.first)] < 0) {
+                                parent[static_cast<size_t>(edge.first)] = node;
+                                order.push_back(edge.first);
+                            }
                         }
                     }
-                    return std::make_pair(cut_cost, partitioning_formatted);
+                    if (order.size() != node_cnt || this->edge_cnt() != static_cast<Id>(node_cnt - 1)) {
+                        throw std::logic_error("The graph is not a tree.");
+                    }
+
+                    NodeWeight total_weight = 0;
+                    for (auto const weight : this->vwgt) {
+                        total_weight += weight;
+                    }
+                    NodeWeight const max_part_weight = gmputils::floor_to_int<NodeWeight>((Rational(1) + imbalance) *
+                            Rational(gmputils::ceil_to_int<NodeWeight>(Rational(total_weight, kparts))));
+
+                    // Merge the components of the children bottom up.
+                    std::vector<NodeWeight> comp_weight(this->vwgt);
+                    std::vector<bool> is_cut(node_cnt, false);
+                    std::vector<std::vector<Id>> children(node_cnt);
+                    for (size_t order_idx = node_cnt; order_idx-- > 0;) {
+                        size_t const node = static_cast<size_t>(order[order_idx]);
+                        if (comp_weight[node] > max_part_weight) {
+                            throw part::PartitionException();
+                        }
+                        std::sort(children[node].begin(), children[node].end(), [&comp_weight](Id lhs, Id rhs) {
+                                return comp_weight[static_cast<size_t>(lhs)] < comp_weight[static_cast<size_t>(rhs)];
+                                });
+                        for (auto const child : children[node]) {
+                            if (comp_weight[node] + comp_weight[static_cast<size_t>(child)] <= max_part_weight) {
+                                comp_weight[node] += comp_weight[static_cast<size_t>(child)];
+                            } else {
+                                is_cut[static_cast<size_t>(child)] = true;
+                            }
+                        }
+                        if (order_idx > 0) {
+                            children[static_cast<size_t>(parent[node])].push_back(static_cast<Id>(node));
+                        }
+                    }
+
+                    // Pack the components first fit decreasing.
+                    std::vector<std::pair<NodeWeight, Id>> comps;
+                    for (auto const node : order) {
+                        if (node == root || is_cut[static_cast<size_t>(node)]) {
+                            comps.emplace_back(comp_weight[static_cast<size_t>(node)], node);
+                        }
+                    }
+                    std::sort(comps.begin(), comps.end(), std::greater<std::pair<NodeWeight, Id>>());
+                    std::vector<NodeWeight> part_weight;
+                    std::vector<Id> part_of_comp(node_cnt, -1);
+                    for (auto const& comp : comps) {
+                        size_t part = 0;
+                        while (part < part_weight.size() && part_weight[part] + comp.first > max_part_weight) {
+                            ++part;
+                        }
+                        if (part == part_weight.size()) {
+                            if (part_weight.size() == static_cast<size_t>(kparts)) {
+                                throw part::PartitionException();
+                            }
+                            part_weight.push_back(0);
+                        }
+                        part_weight[part] += comp.first;
+                        part_of_comp[static_cast<size_t>(comp.second)] = static_cast<Id>(part);
+                    }
+
+                    for (auto const node : order) {
+                        size_t const node_st = static_cast<size_t>(node);
+                        partitioning[node_st] = (node == root || is_cut[node_st]) ?
+                            part_of_comp[node_st] : partitioning[static_cast<size_t>(parent[node_st])];
+                    }
+                    return std::make_pair(this->partition_cost(partitioning, 1), partitioning);
+                }
+
+                /**
+                 * Partition the graph using the method of Feldmann and Foschini, where the signatures
+                 * are pruned with the cost of a greedy partition as upper bound.
+                 * The result has the same cost as the one of partition() unless the greedy partition
+                 * is cheaper, in which case the greedy partition is returned.
+                 * This only works if the graph is a tree.
+                 * @param kparts The number of parts to partition into.
+                 * @param imbalance The desired maximum imbalance of the partitioning.
+                 * @param root The desired root (default 0).
+                 * @param statistics If this is set, the statistics of the cut are stored there (default nullptr).
+                 * @returns The partitioning.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 * @see partition_greedy()
+                 */
+                PartitionResult partition_bounded(Id kparts, Rational imbalance, Id root=0,
+                        cut::CutStatistics* statistics=nullptr) const {
+                    PartitionResult greedy_result;
+                    try {
+                        greedy_result = this->partition_greedy(kparts, imbalance, root);
+                    } catch (part::PartitionException const&) {
+                        return this->partition(kparts, imbalance, root, statistics);
+                    }
+                    try {
+                        return this->partition_with_bound(kparts, imbalance, greedy_result.first, root, statistics);
+                    } catch (part::PartitionException const&) {
+                        return greedy_result;
+                    }
+                }
+
+                /**
+                 * Partition the graph using the method of Feldmann and Foschini, where the signatures
+                 * are pruned with the upper bound \p max_cut_cost.
+                 * The result is the same as the one of partition() if its cost does not exceed the bound.
+                 * This only works if the graph is a tree.
+                 * @param kparts The number of parts to partition into.
+                 * @param imbalance The desired maximum imbalance of the partitioning.
+                 * @param max_cut_cost The upper bound on the cut cost.
+                 * @param root The desired root (default 0).
+                 * @param statistics If this is set, the statistics of the cut are stored there (default nullptr).
+                 * @returns The partitioning.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 * @throws part::PartitionException if no partition within the bound is found.
+                 */
+                PartitionResult partition_with_bound(Id kparts, Rational imbalance, EdgeWeight max_cut_cost,
+                        Id root=0, cut::CutStatistics* statistics=nullptr) const {
+                    cut::Tree<Id, NodeWeight, EdgeWeight> tree = this->to_tree(root);
+                    cut::CutOptions options;
+                    options.delete_signatures = true;
+                    options.prune_unpackable = true;
+                    options.statistics = statistics;
+                    options.max_cut_cost = static_cast<double>(max_cut_cost);
+                    auto signatures = tree.cut(imbalance, kparts, options);
+                    return this->pack_signatures(signatures);
+                }
+
+                /**
+                 * Determine the roots for which the tree partitioning is expected to be fastest.
+                 * The candidates are the centroids, the centers, the node with the highest degree
+                 * and node 0. They are ranked by cut::Tree::estimate_cut_work().
+                 * This only works if the graph is a tree.
+                 * @param root_cnt The maximum number of roots to return.
+                 * @returns The roots, the most promising first.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 */
+                std::vector<Id> select_roots(size_t root_cnt) const {
+                    size_t const node_cnt = this->vwgt.size();
+                    if (node_cnt == 0) {
+                        return std::vector<Id>();
+                    }
+
+                    // Root the graph at node 0 to compute the subtree weights.
+                    std::vector<Id> order;
+                    std::vector<Id> parent(node_cnt, -1);
+                    order.reserve(node_cnt);
+                    order.push_back(0);
+                    parent[0] = 0;
+                    for (size_t order_idx = 0; order_idx < order.size(); ++order_idx) {
+                        Id const node = order[order_idx];
+                        for (auto const& edge : this->adjncy[static_cast<size_t>(node)]) {
+                            if (parent[static_cast<size_t>(edge.first)] < 0) {
+                                parent[static_cast<size_t>(edge.first)] = node;
+                                order.push_back(edge.first);
+                            }
+                        }
+                    }
+                    if (order.size() != node_cnt) {
+                        throw std::logic_error("The graph is not a tree.");
+                    }
+
+                    std::vector<NodeWeight> subtree_weight(this->vwgt);
+                    for (size_t order_idx = node_cnt; order_idx-- > 1;) {
+                        Id const node = order[order_idx];
+                        subtree_weight[static_cast<size_t>(parent[static_cast<size_t>(node)])] +=
+                            subtree_weight[static_cast<size_t>(node)];
+                    }
+                    NodeWeight const total_weight = subtree_weight[0];
+
+                    // A centroid minimizes the weight of the heaviest component after its removal.
+                    std::vector<NodeWeight> heaviest_comp(node_cnt, 0);
+                    for (size_t node = 0; node < node_cnt; ++node) {
+                        heaviest_comp[node] = total_weight - subtree_weight[node];
+                    }
+                    for (size_t order_idx = 1; order_idx < node_cnt; ++order_idx) {
+                        size_t const node = static_cast<size_t>(order[order_idx]);
+                        size_t const node_parent = static_cast<size_t>(parent[node]);
+                        heaviest_comp[node_parent] = std::max(heaviest_comp[node_parent], subtree_weight[node]);
+                    }
+                    NodeWeight const min_heaviest_comp = *std::min_element(heaviest_comp.cbegin(), heaviest_comp.cend());
+
+                    // A center is in the middle of a longest path.
+                    auto farthest = [this, node_cnt](Id start, std::vector<Id>& pred) -> Id {
+                        std::vector<Id> queue(1, start);
+                        pred.assign(node_cnt, -1);
+                        pred[static_cast<size_t>(start)] = start;
+                        for (size_t queue_idx = 0; queue_idx < queue.size(); ++queue_idx) {
+                            for (auto const& edge : this->adjncy[static_cast<size_t>(queue[queue_idx])]) {
+                                if (pred[static_cast<size_t>(edge.first)] < 0) {
+                                    pred[static_cast<size_t>(edge.first)] = queue[queue_idx];
+                                    queue.push_back(edge.first);
+                                }
+                            }
+                        }
+                        return queue.back();
+                    };
+                    std::vector<Id> pred;
+                    Id const path_begin = farthest(0, pred);
+                    Id const path_end = farthest(path_begin, pred);
+                    std::vector<Id> path(1, path_end);
+                    while (path.back() != path_begin) {
+                        path.push_back(pred[static_cast<size_t>(path.back())]);
+                    }
+
+                    std::vector<Id> candidates;
+                    for (size_t node = 0; node < node_cnt; ++node) {
+                        if (heaviest_comp[node] == min_heaviest_comp) {
+                            candidates.push_back(static_cast<Id>(node));
+                        }
+                    }
+                    candidates.push_back(path[(path.size() - 1) / 2]);
+                    candidates.push_back(path[path.size() / 2]);
+                    Id max_degree_node = 0;
+                    for (size_t node = 0; node < node_cnt; ++node) {
+                        if (this->adjncy[node].size() > this->adjncy[static_cast<size_t>(max_degree_node)].size()) {
+                            max_degree_node = static_cast<Id>(node);
+                        }
+                    }
+                    candidates.push_back(max_degree_node);
+                    candidates.push_back(0);
+                    std::sort(candidates.begin(), candidates.end());
+                    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+                    std::vector<std::pair<double, Id>> ranked;
+                    for (auto const root : candidates) {
+                        ranked.emplace_back(this->to_tree(root).estimate_cut_work(), root);
+                    }
+                    std::sort(ranked.begin(), ranked.end());
+
+                    std::vector<Id> roots;
+                    for (size_t rank = 0; rank < std::min(root_cnt, ranked.size()); ++rank) {
+                        roots.push_back(ranked[rank].second);
+                    }
+                    return roots;
+                }
+
+                /**
+                 * Partition the graph using the method of Feldmann and Foschini with an automatically
+                 * selected root. The root only affects the running time, not the guarantee on the
+                 * quality of the partition. \n
+                 * If \p root_cnt is greater than one, the most promising roots according to
+                 * select_roots() are partitioned concurrently. Once the first of them is partitioned the
+                 * others are cancelled. The cost of the partition does not depend on the root, but which
+                 * roots finish before the cancellation does, hence the partition itself may differ from
+                 * run to run. Of the roots which finish, the one with the smallest id is used.
+                 * This only works if the graph is a tree.
+                 * @param kparts The number of parts to partition into.
+                 * @param imbalance The desired maximum imbalance of the partitioning.
+                 * @param root_cnt The number of roots to race (default 1).
+                 * @param thread_cnt The maximum number of roots which are raced
+                 *  (default 0 for all hardware threads).
+                 * @returns The partitioning.
+                 *
+                 * @throws std::logic_error if the graph is not a tree.
+                 * @see select_roots()
+                 */
+                PartitionResult partition_auto_root(Id kparts, Rational imbalance,
+                        size_t root_cnt=1, size_t thread_cnt=0) const {
+                    std::vector<Id> const roots = this->select_roots(
+                            std::min(std::max(root_cnt, static_cast<size_t>(1)), parutils::get_thread_cnt(thread_cnt)));
+                    if (roots.size() <= 1) {
+                        return this->partition(kparts, imbalance, roots.empty() ? 0 : roots.front());
+                    }
+
+                    std::atomic<bool> cancel(false);
+                    std::vector<std::future<PartitionResult>> futures;
+                    for (auto const root : roots) {
+                        futures.push_back(std::async(std::launch::async, [this, kparts, imbalance, root, &cancel](){
+                                    cut::Tree<Id, NodeWeight, EdgeWeight> tree = this->to_tree(root);
+                                    cut::CutOptions options;
+                                    options.delete_signatures = true;
+                                    options.prune_unpackable = true;
+                                    options.cancel = &cancel;
+                                    auto signatures = tree.cut(imbalance, kparts, options);
+                                    PartitionResult root_result = this->pack_signatures(signatures);
+                                    cancel.store(true);
+                                    return root_result;
+                                    }));
+                    }
+
+                    PartitionResult result;
+                    bool has_result = false;
+                    Id result_root = 0;
+                    std::exception_ptr error;
+                    for (size_t root_idx = 0; root_idx < roots.size(); ++root_idx) {
+                        try {
+                            PartitionResult root_result = futures[root_idx].get();
+                            if (!has_result || roots[root_idx] < result_root) {
+                                result = std::move(root_result);
+                                result_root = roots[root_idx];
+                                has_result = true;
+                            }
+                        } catch (cut::CutCancelledException const&) {
+                        } catch (...) {
+                            error = std::current_exception();
+                        }
+                    }
+                    if (!has_result) {
+                        std::rethrow_exception(error);
+                    }
+                    return result;
                 }
 
                 /**
                  * Calculate the cost of a partition in the graph.
                  * Useful if the partitioning was calculated on a spanning tree of the graph
                  * and the cost is therefore not accurate.
+                 * The nodes are processed in parallel.
                  * @param partitioning The partitioning.
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
                  * @returns The accumalated weight of the edges cut.
+                 *
+                 * @throws std::invalid_argument if there is not a part for each node.
+                 */
+                EdgeWeight partition_cost(std::vector<Id> const& partitioning, size_t thread_cnt=0) const {
+                    if (partitioning.size() < this->vwgt.size()) {
+                        throw std::invalid_argument("Need a part for each node.");
+                    }
+                    return parutils::parallel_reduce(this->vwgt.size(), thread_cnt, static_cast<EdgeWeight>(0),
+                            [this, &partitioning](size_t node) -> EdgeWeight {
+                            EdgeWeight node_cost = 0;
+                            for (auto const& edge : this->adjncy[node]) {
+                                size_t const to_node = static_cast<size_t>(edge.first);
+                                if (to_node >= node && partitioning[node] != partitioning[to_node]) {
+                                    node_cost += edge.second;
+                                }
+                            }
+                            return node_cost;
+                            },
+                            [](EdgeWeight lhs, EdgeWeight rhs){ return lhs + rhs; });
+                }
+
+                /**
+                 * Calculate the imbalance of a partition in the graph. This is the smallest imbalance
+                 * the partition obeys, i.e. the weight of the heaviest part divided by
+                 * ceil(total_weight/kparts) minus one.
+                 * @param partitioning The partitioning.
+                 * @param kparts The number of parts.
+                 * @returns The imbalance.
+                 *
+                 * @throws std::invalid_argument if there is not a part for each node or a part is out of range.
                  */
-                EdgeWeight partition_cost(std::vector<Id> const& partitioning) const {
-                    EdgeWeight cost = 0;
+                Rational partition_imbalance(std::vector<Id> const& partitioning, Id kparts) const {
+                    if (partitioning.size() < this->vwgt.size()) {
+                        throw std::invalid_argument("Need a part for each node.");
+                    }
+                    std::vector<NodeWeight> part_weight(static_cast<size_t>(kparts), 0);
+                    NodeWeight total_weight = 0;
+                    for (size_t node = 0; node < this->vwgt.size(); ++node) {
+                        if (partitioning[node] < 0 || partitioning[node] >= kparts) {
+                            throw std::invalid_argument("The part of a node is out of range.");
+                        }
+                        part_weight[static_cast<size_t>(partitioning[node])] += this->vwgt[node];
+                        total_weight += this->vwgt[node];
+                    }
+                    NodeWeight const weight_per_part = gmputils::ceil_to_int<NodeWeight>(Rational(total_weight, kparts));
+                    if (weight_per_part == 0) {
+                        return Rational(0);
+                    }
+                    Rational imbalance(*std::max_element(part_weight.cbegin(), part_weight.cend()), weight_per_part);
+                    imbalance.canonicalize();
+                    return imbalance - Rational(1);
+                }
+
+                /**
+                 * Contracts the nodes of the graph according to \p node_labels.
+                 * All nodes with the same label are merged into the node with the id of the label.
+                 * The weight of a merged node is the sum of the weights of its nodes and it
+                 * represents the union of the nodes they represent. Edges between merged nodes
+                 * are removed and parallel edges are combined by adding their weights.
+                 * The resulting graph is built in a single pass over the edges.
+                 * @param node_labels The label for each node, all labels must be smaller
+                 *  than \p label_cnt.
+                 * @param label_cnt The number of nodes after the contraction.
+                 *
+                 * @throws std::invalid_argument if there is not a label for each node or a label
+                 *  is out of range.
+                 */
+                void contract_nodes(std::vector<Id> const& node_labels, Id label_cnt) {
+                    if (node_labels.size() != static_cast<size_t>(this->node_cnt())) {
+                        throw std::invalid_argument("Need exactly one label per node.");
+                    }
+                    size_t const label_cnt_st = static_cast<size_t>(label_cnt);
+
+                    std::vector<NodeWeight> result_vwgt(label_cnt_st, 0);
+                    std::vector<NodeSet> result_vrepr(label_cnt_st);
                     for (Id node = 0; node < this->node_cnt(); ++node) {
-                        for (auto const& edge : this->inc_edges(node)) {
-                            if (edge.first >= node &&
-                                    partitioning.at(node) != partitioning.at(edge.first)) {
-                                cost += edge.second;
+                        Id const label = node_labels[static_cast<size_t>(node)];
+                        if (static_cast<size_t>(label) >= label_cnt_st) {
+                            throw std::invalid_argument("Label of node " + std::to_string(node) + 
+                                    " is out of range.");
+                        }
+                        result_vwgt[static_cast<size_t>(label)] += this->vwgt[static_cast<size_t>(node)];
+                        result_vrepr[static_cast<size_t>(label)].insert(
+                                this->vrepr[static_cast<size_t>(node)].cbegin(),
+                                this->vrepr[static_cast<size_t>(node)].cend());
+                    }
+
+                    std::vector<std::unordered_map<Id, EdgeWeight>> result_adjncy(label_cnt_st);
+                    for (Id node = 0; node < this->node_cnt(); ++node) {
+                        Id const from_in_res = node_labels[static_cast<size_t>(node)];
+                        for (auto const& inc_edge : this->adjncy[static_cast<size_t>(node)]) {
+                            Id const to_in_res = node_labels[static_cast<size_t>(inc_edge.first)];
+                            if (inc_edge.first >= node && from_in_res != to_in_res) {
+                                result_adjncy[static_cast<size_t>(from_in_res)][to_in_res] += inc_edge.second;
+                                result_adjncy[static_cast<size_t>(to_in_res)][from_in_res] += inc_edge.second;
                             }
                         }
                     }
-                    return cost;
+
+                    this->adjncy = std::move(result_adjncy);
+                    this->vrepr = std::move(result_vrepr);
+                    this->vwgt = std::move(result_vwgt);
                 }
 
                 /**
                  * Contracts the edges in \p matching.
                  * This will change which nodes a node represents and
-                 * also the id of every node.
+                 * also the id of every node. The matched nodes get the ids in the order of
+                 * \p matching, the unmatched nodes follow in the order of their ids.
                  * @param matching The matching.
+                 * @see contract_nodes()
                  */
                 void contract_edges(Matching const& matching) {
                     std::vector<bool> is_matched(this->node_cnt());
@@ -666,49 +1310,22 @@ namespace graph {
                         match(edge.second);
                     }
 
-                    Graph<Id, NodeWeight, EdgeWeight> result_graph(this->node_cnt() - matching.size());
-                    std::vector<bool> is_in_result_graph(this->node_cnt());
                     std::vector<Id> node_in_result_graph(this->node_cnt());
-
                     Id curr_node = 0;
                     for (auto const& edge : matching) {
-                        result_graph.node_weight(curr_node, 
-                                this->node_weight(edge.first) + this->node_weight(edge.second));
-
-                        NodeSet new_vrepr;
-                        std::set_union(this->vrepr.at(edge.first).cbegin(), this->vrepr.at(edge.first).cend(),
-                                this->vrepr.at(edge.second).cbegin(), this->vrepr.at(edge.second).cend(),
-                                std::inserter(new_vrepr, new_vrepr.end()));
-                        result_graph.vrepr.at(curr_node) = new_vrepr;
-
-                        is_in_result_graph.at(edge.first) = true;
-                        is_in_result_graph.at(edge.second) = true;
                         node_in_result_graph.at(edge.first) = curr_node;
                         node_in_result_graph.at(edge.second) = curr_node;
                         curr_node += 1;
                     }
 
                     for (Id node = 0; node < this->node_cnt(); ++node) {
-                        if (!is_in_result_graph[node]) {
-                            result_graph.node_weight(curr_node, this->node_weight(node));
-                            result_graph.vrepr.at(curr_node) = this->node_repr(node);
-                            is_in_result_graph[node] = true;
+                        if (!is_matched[node]) {
                             node_in_result_graph.at(node) = curr_node;
                             curr_node += 1;
                         }
                     }
 
-                    for (Id node = 0; node < this->node_cnt(); ++node) {
-                        for (auto const& inc_edge : this->inc_edges(node)) {
-                            Id const from_in_res = node_in_result_graph.at(node);
-                            Id const to_in_res = node_in_result_graph.at(inc_edge.first);
-                            if (inc_edge.first >= node && from_in_res != to_in_res) {
-                                result_graph.add_edge_weight(
-                                        from_in_res, to_in_res, inc_edge.second);
-                            }
-                        }
-                    }
-                    *this = result_graph;
+                    this->contract_nodes(node_in_result_graph, curr_node);
                 }
         };
 }
@@ -5,12 +5,16 @@
 
 #include<cstdint>
 #include<fstream>
+#include<future>
 #include<iostream>
 #include<limits>
 #include<memory>
 #include<random>
+#include<stdexcept>
 #include<string>
+#include<vector>
 
+#include "FileUtils.hpp"
 #include "Graph.hpp"
 #include "GraphIo.hpp"
 #include "GraphUtils.hpp"
@@ -425,20 +429,24 @@ namespace graphgen {
             struct Mst : public IGraphGen<Id, NodeWeight, EdgeWeight> {
                 public:
                     std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> graph_gen;
+                    size_t thread_cnt;
 
                     /**
                      * Compute the MST for a graph.
                      * When the graph generator is called then the MST is computed for the 
                      * graph returned by \p graph_gen.
                      * @param graph_gen The graph generator to use.
+                     * @param thread_cnt The number of threads used to compute the MST
+                     *  (default 0 for all hardware threads).
                      *
                      * @see graph::mst()
                      */
-                    Mst(std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> const& graph_gen) :
-                        graph_gen(graph_gen) {}
+                    Mst(std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> const& graph_gen,
+                            size_t thread_cnt=0) :
+                        graph_gen(graph_gen), thread_cnt(thread_cnt) {}
 
                     graph::Graph<Id, NodeWeight, EdgeWeight> operator()(size_t seed=0) const override {
-                        return graph::mst<Id, NodeWeight, EdgeWeight>((*graph_gen)(seed));
+                        return graph::mst<Id, NodeWeight, EdgeWeight>((*graph_gen)(seed), this->thread_cnt);
                     }
             };
 
@@ -451,6 +459,7 @@ namespace graphgen {
                 public:
                     std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> graph_gen;
                     size_t rst_seed;
+                    size_t thread_cnt;
 
                     /**
                      * Compute the RST for a graph.
@@ -458,16 +467,82 @@ namespace graphgen {
                      * graph returned by \p graph_gen.
                      * @param graph_gen The graph generator to use.
                      * @param rst_seed The seed for generating the rst (default 0).
+                     * @param thread_cnt The number of threads used to compute the RST
+                     *  (default 0 for all hardware threads).
                      *
                      * @see graph::rst()
                      */
                     Rst(std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> const& graph_gen,
-                            size_t rst_seed=0) :
-                        graph_gen(graph_gen), rst_seed(rst_seed) {}
+                            size_t rst_seed=0, size_t thread_cnt=0) :
+                        graph_gen(graph_gen), rst_seed(rst_seed), thread_cnt(thread_cnt) {}
 
                     graph::Graph<Id, NodeWeight, EdgeWeight> operator()(size_t seed=0) const override {
                         return graph::rst<Id, NodeWeight, EdgeWeight, RandGen>(
-                                (*graph_gen)(seed), this->rst_seed);
+                                (*graph_gen)(seed), this->rst_seed, this->thread_cnt);
+                    }
+            };
+
+    /**
+     * Use the FRT tree embedding to convert a graph into a tree.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t,
+        typename EdgeWeight=int32_t, typename RandGen=std::mt19937_64>
+            struct Frt : public IGraphGen<Id, NodeWeight, EdgeWeight> {
+                public:
+                    std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> graph_gen;
+                    size_t frt_seed;
+                    size_t thread_cnt;
+
+                    /**
+                     * Compute the FRT tree for a graph.
+                     * When the graph generator is called then the tree is computed for the
+                     * graph returned by \p graph_gen.
+                     * @param graph_gen The graph generator to use.
+                     * @param frt_seed The seed for the random order and radii (default 0).
+                     * @param thread_cnt The number of threads used to compute the tree
+                     *  (default 0 for all hardware threads).
+                     *
+                     * @see graph::frt_tree()
+                     */
+                    Frt(std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> const& graph_gen,
+                            size_t frt_seed=0, size_t thread_cnt=0) :
+                        graph_gen(graph_gen), frt_seed(frt_seed), thread_cnt(thread_cnt) {}
+
+                    graph::Graph<Id, NodeWeight, EdgeWeight> operator()(size_t seed=0) const override {
+                        return graph::frt_tree<Id, NodeWeight, EdgeWeight, RandGen>(
+                                (*graph_gen)(seed), this->frt_seed, this->thread_cnt);
+                    }
+            };
+
+    /**
+     * Use recursive bisection to convert a graph into a decomposition tree.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t,
+        typename EdgeWeight=int32_t>
+            struct Decompose : public IGraphGen<Id, NodeWeight, EdgeWeight> {
+                public:
+                    std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> graph_gen;
+                    graph::Rational imbalance;
+                    size_t thread_cnt;
+
+                    /**
+                     * Compute the decomposition tree for a graph.
+                     * When the graph generator is called then the tree is computed for the
+                     * graph returned by \p graph_gen.
+                     * @param graph_gen The graph generator to use.
+                     * @param imbalance The maximum imbalance of each bisection (default 1/10).
+                     * @param thread_cnt The number of threads used to compute the tree
+                     *  (default 0 for all hardware threads).
+                     *
+                     * @see graph::decomposition_tree()
+                     */
+                    Decompose(std::shared_ptr<IGraphGen<Id, NodeWeight, EdgeWeight>> const& graph_gen,
+                            graph::Rational imbalance=graph::Rational(1, 10), size_t thread_cnt=0) :
+                        graph_gen(graph_gen), imbalance(imbalance), thread_cnt(thread_cnt) {}
+
+                    graph::Graph<Id, NodeWeight, EdgeWeight> operator()(size_t seed=0) const override {
+                        return graph::decomposition_tree<Id, NodeWeight, EdgeWeight>(
+                                (*graph_gen)(seed), this->imbalance, this->thread_cnt);
                     }
             };
 
@@ -541,47 +616,189 @@ namespace graphgen {
     template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
         struct FromFile : public IGraphGen<Id, NodeWeight, EdgeWeight> {
             private:
-                std::vector<graph::Graph<Id, NodeWeight, EdgeWeight>> graphs;
+                using Graph = graph::Graph<Id, NodeWeight, EdgeWeight>;
+
+                std::vector<Graph> graphs;
                 std::string filename;
                 bool do_read_on_demand;
+                bool do_prefetch;
+
+                /** The mapped file if graphs are read on demand. */
+                std::shared_ptr<fileutils::MappedFile> file;
+                /** The offsets of the graphs in the file followed by the end of the last indexed graph. */
+                mutable std::vector<uint64_t> graph_offsets;
+                /** The seed of the graph which is prefetched. */
+                mutable size_t prefetched_seed;
+                /** The graph which is prefetched. */
+                mutable std::shared_future<Graph> prefetched_graph;
+
+                /**
+                 * Getter for the name of the sidecar file which stores the offsets of the graphs.
+                 * @returns The name of the index file.
+                 */
+                std::string index_filename() const {
+                    return this->filename + ".idx";
+                }
+
+                /**
+                 * Load the offsets of the graphs from the index file. 
+                 * The index is only used if the size and the modification time of the file are still the same.
+                 * @returns True if the index was loaded.
+                 */
+                bool load_index() {
+                    std::ifstream index_file(this->index_filename());
+                    std::string format;
+                    fileutils::FileStatus status;
+                    size_t offset_cnt;
+                    if (!(index_file >> format >> status.size >> status.mtime_sec >> status.mtime_nsec >> offset_cnt) ||
+                            format != "graph_offsets_v1" || !(status == fileutils::file_status(this->filename))) {
+                        return false;
+                    }
+                    std::vector<uint64_t> offsets(offset_cnt);
+                    for (auto& offset : offsets) {
+                        if (!(index_file >> offset) || offset > status.size) {
+                            return false;
+                        }
+                    }
+                    this->graph_offsets = offsets;
+                    return !this->graph_offsets.empty();
+                }
+
+                /**
+                 * Store the offsets of the graphs in the index file. 
+                 * Failing to write the index is not an error since it only speeds up later runs.
+                 */
+                void store_index() const {
+                    std::ofstream index_file(this->index_filename());
+                    fileutils::FileStatus const status = fileutils::file_status(this->filename);
+                    index_file << "graph_offsets_v1 " << status.size << " " << status.mtime_sec << " ";
+                    index_file << status.mtime_nsec << " " << this->graph_offsets.size() << '\n';
+                    for (auto const offset : this->graph_offsets) {
+                        index_file << offset << '\n';
+                    }
+                }
+
+                /**
+                 * Extend the offsets of the graphs such that the graph \p seed is indexed.
+                 * Only the headers and line breaks are scanned, the nodes are not parsed.
+                 * @param seed The seed of the graph.
+                 * @returns True if the index was extended.
+                 */
+                bool extend_index(size_t seed) const {
+                    bool is_extended = false;
+                    while (this->graph_offsets.size() < seed + 2) {
+                        char const* const graph_begin = this->file->begin() + this->graph_offsets.back();
+                        char const* const graph_end = graphio::find_graph_end<Id>(graph_begin, this->file->end());
+                        this->graph_offsets.push_back(static_cast<uint64_t>(graph_end - this->file->begin()));
+                        is_extended = true;
+                    }
+                    return is_extended;
+                }
+
+                /**
+                 * Parse the graph at \p offset in the mapped file.
+                 * @param offset The offset of the graph as stored in the index.
+                 * @returns The graph.
+                 */
+                Graph parse_at(uint64_t offset) const {
+                    Graph graph;
+                    graphio::parse_graph(this->file->begin() + offset, this->file->end(), graph);
+                    return graph;
+                }
 
             public:
                 /**
                  * Read in \p graph_cnt graphs from file \p filename.
+                 * Regular files are mapped into memory and parsed in parallel, other files like pipes
+                 * are read as a stream. Graphs can be stored in the METIS or the binary format, the
+                 * format is detected for each graph. \n
+                 * If the graphs are read on demand, the offsets of the first \p graph_cnt graphs are indexed
+                 * when constructing the object and stored in the file <code>filename + ".idx"</code>. Later
+                 * runs load the offsets from there as long as the file did not change.
                  * @param filename The file to use "-" for stdin.
                  * @param graph_cnt The number of graphs to read from the file.
                  * @param do_read_on_demand Indicates whether the graphs should be read only when 
                  *  needed to save memory. This only works for files. Default: false.
+                 * @param do_prefetch Indicates whether the next graph should be parsed in the background
+                 *  when reading on demand. Default: false.
                  */
-                FromFile(std::string filename, size_t graph_cnt=1, bool do_read_on_demand=false) :
-                    filename(filename), do_read_on_demand(do_read_on_demand) {
+                FromFile(std::string filename, size_t graph_cnt=1, bool do_read_on_demand=false, bool do_prefetch=false) :
+                    filename(filename), do_read_on_demand(do_read_on_demand), do_prefetch(do_prefetch),
+                    prefetched_seed(std::numeric_limits<size_t>::max()) {
                         if (!do_read_on_demand) {
                             if (filename == std::string("-")) {
                                 for (size_t graph_idx = 0; graph_idx < graph_cnt; ++graph_idx) {
                                     graphs.emplace_back();
-                                    std::cin >> graphs.back();
+                                    graphio::read_graph(std::cin, graphs.back());
+                                }
+                            } else if (!fileutils::is_regular_file(filename)) {
+                                std::ifstream file(filename, std::ios::binary);
+                                if (!file.is_open()) {
+                                    throw std::runtime_error("Opening " + filename + " failed.");
+                                }
+                                for (size_t graph_idx = 0; graph_idx < graph_cnt; ++graph_idx) {
+                                    graphs.emplace_back();
+                                    graphio::read_graph(file, graphs.back());
                                 }
                             } else {
-                                std::ifstream file(filename);
+                                fileutils::MappedFile file(filename);
+                                char const* pos = file.begin();
                                 for (size_t graph_idx = 0; graph_idx < graph_cnt; ++graph_idx) {
                                     graphs.emplace_back();
-                                    file >> graphs.back();
+                                    pos = graphio::parse_graph(pos, file.end(), graphs.back());
                                 }
                             }
+                        } else if (filename != std::string("-")) {
+                            this->file = std::make_shared<fileutils::MappedFile>(filename);
+                            if (!this->load_index()) {
+                                this->graph_offsets.assign(1, 0);
+                            }
+                            if (graph_cnt > 0 && this->extend_index(graph_cnt - 1)) {
+                                this->store_index();
+                            }
                         }
                     }
 
-                graph::Graph<Id, NodeWeight, EdgeWeight> operator()(size_t seed=0) const override {
+                /**
+                 * Destructor. Waits for a graph which is prefetched.
+                 */
+                ~FromFile() {
+                    if (this->prefetched_graph.valid()) {
+                        this->prefetched_graph.wait();
+                    }
+                }
+
+                Graph operator()(size_t seed=0) const override {
                     if (do_read_on_demand) {
-                        graph::Graph<Id, NodeWeight, EdgeWeight> graph;
                         if (filename == std::string("-")) {
+                            Graph graph;
                             for (size_t graph_idx = 0; graph_idx <= seed; ++graph_idx) {
-                                std::cin >> graph;
+                                graphio::read_graph(std::cin, graph);
                             }
+                            return graph;
+                        }
+
+                        this->extend_index(seed);
+                        Graph graph;
+                        if (this->prefetched_graph.valid() && this->prefetched_seed == seed) {
+                            graph = this->prefetched_graph.get();
                         } else {
-                            std::ifstream file(filename);
-                            for (size_t graph_idx = 0; graph_idx <= seed; ++graph_idx) {
-                                file >> graph;
+                            graph = this->parse_at(this->graph_offsets.at(seed));
+                        }
+
+                        if (this->do_prefetch) {
+                            if (this->prefetched_graph.valid()) {
+                                this->prefetched_graph.wait();
+                            }
+                            this->prefetched_graph = std::shared_future<Graph>();
+                            try {
+                                this->extend_index(seed + 1);
+                                this->prefetched_seed = seed + 1;
+                                this->prefetched_graph = std::async(std::launch::async,
+                                        [this](uint64_t offset){ return this->parse_at(offset); },
+                                        this->graph_offsets[seed + 1]).share();
+                            } catch (std::invalid_argument const&) {
+                                // There is no next graph in the file.
                             }
                         }
                         return graph;
@@ -596,6 +813,7 @@ namespace graphgen {
      * The maximum value of \p EdgeWeight is treated as infinity.
      * This is used to contract to deal with the infinity edges of the hierarchical 
      * decomposition.
+     * @see graph::contract_inf_edges()
      */
     template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
         struct ContractInfEdges : public IGraphGen<Id, NodeWeight, EdgeWeight> {
@@ -617,23 +835,7 @@ namespace graphgen {
                 graph::Graph<Id, NodeWeight, EdgeWeight> operator()(size_t seed=0) const override {
                     using Graph = graph::Graph<Id, NodeWeight, EdgeWeight>;
                     Graph graph = (*this->graph_gen)(seed);
-                    typename Graph::Matching matching;
-                    do {
-                        matching = typename Graph::Matching();
-                        std::vector<bool> is_matched(graph.node_cnt());
-                        for (Id node = 0; node < graph.node_cnt(); ++node) {
-                            for (auto const& edge : graph.inc_edges(node)) {
-                                if (edge.second == this->infty &&
-                                        !is_matched.at(node) && !is_matched.at(edge.first)) {
-                                    matching.emplace_back(node, edge.first);
-                                    is_matched[node] = true;
-                                    is_matched[edge.first] = true;
-                                }
-                            }
-                        } 
-                        graph.contract_edges(matching);
-                    } while (matching.size() > 0);
-
+                    graph::contract_inf_edges(graph, this->infty);
                     return graph;
                 }
         };
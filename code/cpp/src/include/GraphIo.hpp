@@ -7,90 +7,473 @@
  */
 #pragma once
 
+#include<algorithm>
 #include<cstdint>
+#include<cstring>
+#include<exception>
 #include<iostream>
+#include<limits>
 #include<sstream>
+#include<stdexcept>
+#include<string>
+#include<tuple>
+#include<utility>
+#include<vector>
 
+#include "FileUtils.hpp"
 #include "Graph.hpp"
+#include "ParallelUtils.hpp"
 
-/**
- * Reads a graph in CSR format from \p is.
- * The format is described in the metis manual in \p deps/metis/manual.
- * @param is The inputstream.
- * @param graph The graph to write to.
- * @returns The input stream.
- */
-template<typename Id, typename NodeWeight, typename EdgeWeight>
-std::istream& operator>>(std::istream& is, graph::Graph<Id, NodeWeight, EdgeWeight>& graph) {
-    Id node_cnt;
-    Id edge_cnt;
+namespace graphio {
+
+    /**
+     * The header of a graph in the METIS format.
+     */
+    template<typename Id>
+        struct MetisHeader {
+            Id node_cnt; /**< The number of nodes. */
+            Id edge_cnt; /**< The number of edges as stated in the header. */
+            bool has_node_weights; /**< Indicates whether each line starts with a node weight. */
+            bool has_edge_weights; /**< Indicates whether each neighbor is followed by an edge weight. */
+        };
 
-    bool has_node_sizes = false;
-    bool has_node_weights = false;
-    bool has_edge_weights = false;
-    std::vector<bool*> fmt({&has_node_sizes, &has_node_weights, &has_edge_weights});
+    /**
+     * A line of a file given by a pointer to its first character and a pointer past its last
+     * character. The line break is not part of the line.
+     */
+    using Line = std::pair<char const*, char const*>;
 
-    std::string line;
-    while (std::getline(is, line) && (line.front() == '%' || line.empty())) {
-        // Skip lines with comments
+    /**
+     * Checks if \p character is a whitespace as defined by <code>std::isspace</code> in the
+     * default locale.
+     * @param character The character.
+     * @returns True if \p character is a whitespace.
+     */
+    inline bool is_space(char character) {
+        return character == ' ' || character == '\t' || character == '\n' ||
+            character == '\v' || character == '\f' || character == '\r';
     }
 
-    std::istringstream line_buffer(line);
-    if (!(line_buffer >> node_cnt >> edge_cnt)) {
-        throw std::invalid_argument("Node count or edge count missing");
-    } 
+    /**
+     * Find the end of the line starting at \p pos.
+     * @param pos The start of the line.
+     * @param end The end of the buffer.
+     * @returns A pointer to the line break ending the line or \p end.
+     */
+    inline char const* find_line_end(char const* pos, char const* end) {
+        void const* line_end = std::memchr(pos, '\n', static_cast<size_t>(end - pos));
+        return (line_end == nullptr) ? end : static_cast<char const*>(line_end);
+    }
 
-    std::string fmt_string;
-    if (line_buffer >> fmt_string) {
-        fmt_string.insert(0, 3 - fmt_string.size(), '0');
-        for (size_t i = 0; i < fmt_string.size(); ++i) {
-            *fmt.at(i) = '1' == fmt_string.at(i);
-        }
-        if (has_node_sizes) {
-            throw std::invalid_argument("Node sizes not supported.");
+    /**
+     * Parse an integer in the same way as the input stream operator does.
+     * Leading whitespace is skipped and the integer may have a sign.
+     * @param pos The position to start parsing at. Is moved past the integer on success.
+     * @param end The end of the buffer.
+     * @param value The parsed value.
+     * @returns False if there is no integer at \p pos or if it does not fit into \p T.
+     */
+    template<typename T>
+        bool parse_int(char const*& pos, char const* end, T& value) {
+            char const* curr = pos;
+            while (curr != end && is_space(*curr)) {
+                ++curr;
+            }
+
+            bool is_negative = false;
+            if (curr != end && (*curr == '-' || *curr == '+')) {
+                is_negative = *curr == '-';
+                ++curr;
+            }
+            if (curr == end || *curr < '0' || *curr > '9') {
+                return false;
+            }
+
+            using Magnitude = unsigned long long;
+            Magnitude const max_magnitude = is_negative ?
+                (std::numeric_limits<T>::is_signed ?
+                 static_cast<Magnitude>(std::numeric_limits<T>::max()) + 1 : 0) :
+                static_cast<Magnitude>(std::numeric_limits<T>::max());
+            Magnitude magnitude = 0;
+            for (; curr != end && *curr >= '0' && *curr <= '9'; ++curr) {
+                Magnitude const digit = static_cast<Magnitude>(*curr - '0');
+                if (magnitude > (max_magnitude - digit) / 10) {
+                    return false;
+                }
+                magnitude = magnitude * 10 + digit;
+            }
+
+            value = is_negative ?
+                static_cast<T>(-static_cast<long long>(magnitude - 1) - 1) : static_cast<T>(magnitude);
+            pos = curr;
+            return true;
         }
-    }
 
-    int ncon;
-    if ((line_buffer >> ncon) && ncon != 1) {
-        throw std::invalid_argument("Multiple node weights not allowed.");
-    }
+    /**
+     * Parse the header line of a graph in the METIS format.
+     * @param begin The start of the header line.
+     * @param end The end of the header line.
+     * @returns The header.
+     *
+     * @throws std::invalid_argument if the header is invalid or uses unsupported features.
+     */
+    template<typename Id>
+        MetisHeader<Id> parse_metis_header(char const* begin, char const* end) {
+            MetisHeader<Id> header;
+            header.has_node_weights = false;
+            header.has_edge_weights = false;
 
-    // Delete all nodes which were in the graph before.
-    graph.resize(0);
-    graph.resize(static_cast<size_t>(node_cnt));
+            char const* pos = begin;
+            if (!parse_int(pos, end, header.node_cnt) || !parse_int(pos, end, header.edge_cnt)) {
+                throw std::invalid_argument("Node count or edge count missing");
+            }
 
-    for (Id curr_node = 0; curr_node < node_cnt && std::getline(is, line); ++curr_node) {
-        if (line.front() == '%') {
-            --curr_node;
-            continue;
+            while (pos != end && is_space(*pos)) {
+                ++pos;
+            }
+            char const* fmt_end = pos;
+            while (fmt_end != end && !is_space(*fmt_end)) {
+                ++fmt_end;
+            }
+            std::string fmt_string(pos, fmt_end);
+            if (!fmt_string.empty()) {
+                if (fmt_string.size() > 3) {
+                    throw std::invalid_argument("Invalid format " + fmt_string + ".");
+                }
+                fmt_string.insert(0, 3 - fmt_string.size(), '0');
+                if (fmt_string.at(0) == '1') {
+                    throw std::invalid_argument("Node sizes not supported.");
+                }
+                header.has_node_weights = fmt_string.at(1) == '1';
+                header.has_edge_weights = fmt_string.at(2) == '1';
+            }
+            pos = fmt_end;
+
+            int ncon;
+            if (parse_int(pos, end, ncon) && ncon != 1) {
+                throw std::invalid_argument("Multiple node weights not allowed.");
+            }
+            return header;
         }
 
-        line_buffer.str(line);
-        line_buffer.clear();
+    /**
+     * Build a graph from the node lines of a graph in the METIS format.
+     * The lines are parsed in parallel into a CSR graph. Afterwards duplicate and one-sided edges
+     * are resolved like the stream operator did it: an edge gets the weight with which it is
+     * listed last, and an edge which is only listed at one of its nodes is added in both directions.
+     * Nodes without a line get weight one and no edges.
+     * @param header The header of the graph.
+     * @param lines The lines of the nodes without comments. There must be at most one line per node.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The graph in CSR format.
+     *
+     * @throws std::invalid_argument if a node weight or an edge weight is missing. If there are
+     *  multiple errors, the one of the first node is reported.
+     * @throws std::out_of_range if an edge leads to a node that does not exist.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        graph::WeightedCsrGraph<Id, NodeWeight, EdgeWeight> parse_metis_nodes(
+                MetisHeader<Id> const& header,
+                std::vector<Line> const& lines,
+                size_t thread_cnt=0) {
+
+            size_t const node_cnt = static_cast<size_t>(std::max(header.node_cnt, static_cast<Id>(0)));
+            graph::WeightedCsrGraph<Id, NodeWeight, EdgeWeight> csr_graph;
+            csr_graph.vwgt.assign(node_cnt, 1);
+
+            // Parse the lines in blocks. Each block stores the edges of its nodes consecutively.
+            struct Block {
+                size_t begin = 0;
+                size_t end = 0;
+                std::vector<Id> adjncy;
+                std::vector<EdgeWeight> adjwgt;
+                std::exception_ptr error;
+            };
+            std::vector<Block> blocks(parutils::get_thread_cnt(thread_cnt));
+            std::vector<size_t> row_len(node_cnt, 0);
+            size_t const block_cnt = parutils::parallel_for_blocks(lines.size(), thread_cnt,
+                    [&header, &lines, &csr_graph, &blocks, &row_len, node_cnt](
+                        size_t begin, size_t end, size_t block_idx){
+                    Block& block = blocks[block_idx];
+                    block.begin = begin;
+                    block.end = end;
+                    try {
+                        for (size_t node = begin; node < end; ++node) {
+                            char const* pos = lines[node].first;
+                            char const* const line_end = lines[node].second;
+
+                            if (header.has_node_weights &&
+                                    !parse_int(pos, line_end, csr_graph.vwgt[node])) {
+                                throw std::invalid_argument(
+                                        "Node weight missing at node " + std::to_string(node) + ".");
+                            }
+
+                            Id to_node;
+                            EdgeWeight edge_weight = 1;
+                            size_t const row_begin = block.adjncy.size();
+                            while (parse_int(pos, line_end, to_node)) {
+                                if (header.has_edge_weights && !parse_int(pos, line_end, edge_weight)) {
+                                    throw std::invalid_argument("Edge weight missing at edge from " +
+                                            std::to_string(node) + " to " + std::to_string(to_node) + ".");
+                                }
+                                if (static_cast<size_t>(to_node) >= node_cnt) {
+                                    throw std::out_of_range("Edge from " + std::to_string(node) + " to " +
+                                            std::to_string(to_node) + " leads to a node which does not exist.");
+                                }
+                                block.adjncy.push_back(to_node);
+                                block.adjwgt.push_back(edge_weight);
+                            }
+                            row_len[node] = block.adjncy.size() - row_begin;
+                        }
+                    } catch (...) {
+                        block.error = std::current_exception();
+                    }
+                    });
+
+            for (size_t block_idx = 0; block_idx < block_cnt; ++block_idx) {
+                if (blocks[block_idx].error) {
+                    std::rethrow_exception(blocks[block_idx].error);
+                }
+            }
+
+            // Copy the blocks into one CSR structure.
+            std::vector<size_t> raw_xadj(node_cnt + 1, 0);
+            for (size_t node = 0; node < node_cnt; ++node) {
+                raw_xadj[node + 1] = raw_xadj[node] + row_len[node];
+            }
+            std::vector<Id> raw_adjncy(raw_xadj.back());
+            std::vector<EdgeWeight> raw_adjwgt(raw_xadj.back());
+            parutils::parallel_for_dynamic(block_cnt, thread_cnt,
+                    [&blocks, &raw_xadj, &raw_adjncy, &raw_adjwgt](size_t block_idx){
+                    Block& block = blocks[block_idx];
+                    std::copy(block.adjncy.cbegin(), block.adjncy.cend(),
+                            raw_adjncy.begin() + static_cast<std::ptrdiff_t>(raw_xadj[block.begin]));
+                    std::copy(block.adjwgt.cbegin(), block.adjwgt.cend(),
+                            raw_adjwgt.begin() + static_cast<std::ptrdiff_t>(raw_xadj[block.begin]));
+                    block.adjncy = std::vector<Id>();
+                    block.adjwgt = std::vector<EdgeWeight>();
+                    });
+
+            // Sort the neighbors of each node and keep only the last occurence of each neighbor.
+            parutils::parallel_for(node_cnt, thread_cnt,
+                    [&raw_xadj, &raw_adjncy, &raw_adjwgt, &row_len](size_t node){
+                    std::vector<std::pair<Id, EdgeWeight>> row;
+                    row.reserve(row_len[node]);
+                    for (size_t edge_idx = raw_xadj[node]; edge_idx < raw_xadj[node + 1]; ++edge_idx) {
+                        row.emplace_back(raw_adjncy[edge_idx], raw_adjwgt[edge_idx]);
+                    }
+                    std::stable_sort(row.begin(), row.end(),
+                            [](std::pair<Id, EdgeWeight> const& one, std::pair<Id, EdgeWeight> const& other){
+                            return one.first < other.first;
+                            });
+
+                    size_t edge_idx = raw_xadj[node];
+                    for (size_t row_idx = 0; row_idx < row.size(); ++row_idx) {
+                        if (row_idx + 1 < row.size() && row[row_idx + 1].first == row[row_idx].first) {
+                            continue;
+                        }
+                        raw_adjncy[edge_idx] = row[row_idx].first;
+                        raw_adjwgt[edge_idx] = row[row_idx].second;
+                        edge_idx += 1;
+                    }
+                    row_len[node] = edge_idx - raw_xadj[node];
+                    });
+
+            // An edge listed at both nodes gets the weight from the node with the larger id since
+            // its line comes last. Edges listed at only one node are collected for the other node.
+            using MissingEdge = std::tuple<Id, Id, EdgeWeight>;
+            std::vector<std::vector<MissingEdge>> missing_edges(parutils::get_thread_cnt(thread_cnt));
+            parutils::parallel_for_blocks(node_cnt, thread_cnt,
+                    [&raw_xadj, &raw_adjncy, &raw_adjwgt, &row_len, &missing_edges](
+                        size_t begin, size_t end, size_t block_idx){
+                    for (size_t node = begin; node < end; ++node) {
+                        for (size_t edge_idx = raw_xadj[node]; edge_idx < raw_xadj[node] + row_len[node]; ++edge_idx) {
+                            size_t const to_node = static_cast<size_t>(raw_adjncy[edge_idx]);
+                            if (to_node == node) {
+                                continue;
+                            }
+                            auto const to_row_begin = raw_adjncy.cbegin() + static_cast<std::ptrdiff_t>(raw_xadj[to_node]);
+                            auto const to_row_end = to_row_begin + static_cast<std::ptrdiff_t>(row_len[to_node]);
+                            auto const reverse = std::lower_bound(to_row_begin, to_row_end, static_cast<Id>(node));
+                            if (reverse != to_row_end && *reverse == static_cast<Id>(node)) {
+                                if (node < to_node) {
+                                    raw_adjwgt[edge_idx] = raw_adjwgt[static_cast<size_t>(reverse - raw_adjncy.cbegin())];
+                                }
+                            } else {
+                                missing_edges[block_idx].emplace_back(
+                                        raw_adjncy[edge_idx], static_cast<Id>(node), raw_adjwgt[edge_idx]);
+                            }
+                        }
+                    }
+                    });
+
+            std::vector<size_t> missing_cnt(node_cnt, 0);
+            for (auto const& block_missing_edges : missing_edges) {
+                for (auto const& edge : block_missing_edges) {
+                    missing_cnt[static_cast<size_t>(std::get<0>(edge))] += 1;
+                }
+            }
+
+            csr_graph.xadj.assign(node_cnt + 1, 0);
+            for (size_t node = 0; node < node_cnt; ++node) {
+                csr_graph.xadj[node + 1] = csr_graph.xadj[node] + row_len[node] + missing_cnt[node];
+            }
+            csr_graph.adjncy.resize(csr_graph.xadj.back());
+            csr_graph.adjwgt.resize(csr_graph.xadj.back());
+            parutils::parallel_for(node_cnt, thread_cnt,
+                    [&csr_graph, &raw_xadj, &raw_adjncy, &raw_adjwgt, &row_len](size_t node){
+                    std::copy(raw_adjncy.cbegin() + static_cast<std::ptrdiff_t>(raw_xadj[node]),
+                            raw_adjncy.cbegin() + static_cast<std::ptrdiff_t>(raw_xadj[node] + row_len[node]),
+                            csr_graph.adjncy.begin() + static_cast<std::ptrdiff_t>(csr_graph.xadj[node]));
+                    std::copy(raw_adjwgt.cbegin() + static_cast<std::ptrdiff_t>(raw_xadj[node]),
+                            raw_adjwgt.cbegin() + static_cast<std::ptrdiff_t>(raw_xadj[node] + row_len[node]),
+                            csr_graph.adjwgt.begin() + static_cast<std::ptrdiff_t>(csr_graph.xadj[node]));
+                    });
+
+            for (auto const& block_missing_edges : missing_edges) {
+                for (auto const& edge : block_missing_edges) {
+                    size_t const node = static_cast<size_t>(std::get<0>(edge));
+                    size_t const edge_idx = csr_graph.xadj[node] + row_len[node];
+                    csr_graph.adjncy[edge_idx] = std::get<1>(edge);
+                    csr_graph.adjwgt[edge_idx] = std::get<2>(edge);
+                    row_len[node] += 1;
+                }
+            }
 
-        NodeWeight curr_node_weight = 1;
-        if(has_node_weights && !(line_buffer >> curr_node_weight)) {
-            std::ostringstream error_msg("Node weight missing at node ",
-                    std::ios_base::app);
-            error_msg << curr_node << '.'; 
-            throw std::invalid_argument(error_msg.str());
+            return csr_graph;
         }
-        graph.node_weight(curr_node, curr_node_weight);
 
-        Id to_node;
-        EdgeWeight edge_weight = 1;
-        while (line_buffer >> to_node) {
-            if (has_edge_weights && !(line_buffer >> edge_weight)) {
-                std::ostringstream error_msg("Edge weight missing at edge from ",
-                        std::ios_base::app);
-                error_msg << curr_node << " to " << to_node << '.';
-                throw std::invalid_argument(error_msg.str());
+    /**
+     * Split a graph in the METIS format in a buffer into its header and the lines of its nodes.
+     * Lines starting with '%' are comments. Empty lines before the header are skipped, empty
+     * lines after the header belong to nodes without edges.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @param line_body A function which is called with each Line of a node in order.
+     * @returns The header and a pointer past the last line which belongs to the graph.
+     *
+     * @throws std::invalid_argument if the header is malformed.
+     */
+    template<typename Id, typename LineBody>
+        std::pair<MetisHeader<Id>, char const*> split_metis_graph(
+                char const* begin,
+                char const* end,
+                LineBody line_body) {
+
+            char const* pos = begin;
+            char const* line_end = pos;
+            while (true) {
+                if (pos == end) {
+                    throw std::invalid_argument("Node count or edge count missing");
+                }
+                line_end = find_line_end(pos, end);
+                if (line_end != pos && *pos != '%') {
+                    break;
+                }
+                pos = (line_end == end) ? end : line_end + 1;
             }
-            graph.edge_weight(curr_node, to_node, edge_weight);
-            graph.edge_weight(to_node, curr_node, edge_weight);
+            auto const header = parse_metis_header<Id>(pos, line_end);
+            pos = (line_end == end) ? end : line_end + 1;
+
+            size_t const node_cnt = static_cast<size_t>(std::max(header.node_cnt, static_cast<Id>(0)));
+            size_t line_cnt = 0;
+            while (line_cnt < node_cnt && pos != end) {
+                line_end = find_line_end(pos, end);
+                if (line_end == pos || *pos != '%') {
+                    line_body(Line(pos, line_end));
+                    ++line_cnt;
+                }
+                pos = (line_end == end) ? end : line_end + 1;
+            }
+            return std::make_pair(header, pos);
+        }
+
+    /**
+     * Parse a graph in the METIS format from a buffer.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @param graph The graph to write to.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns A pointer past the last line which belongs to the graph. A following graph
+     *  can be read from there.
+     *
+     * @throws std::invalid_argument if the graph is malformed.
+     * @see split_metis_graph()
+     * @see parse_metis_nodes()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        char const* parse_metis_graph(
+                char const* begin,
+                char const* end,
+                graph::Graph<Id, NodeWeight, EdgeWeight>& graph,
+                size_t thread_cnt=0) {
+
+            std::vector<Line> lines;
+            auto const header_and_end = split_metis_graph<Id>(begin, end, [&lines](Line const& line){
+                    lines.push_back(line);
+                    });
+
+            graph = graph::Graph<Id, NodeWeight, EdgeWeight>(
+                    parse_metis_nodes<Id, NodeWeight, EdgeWeight>(header_and_end.first, lines, thread_cnt), thread_cnt);
+            return header_and_end.second;
         }
+
+    /**
+     * Read a single graph in the METIS format from a file.
+     * The file is mapped into memory and parsed in parallel.
+     * @param filename The name of the file.
+     * @param graph The graph to write to.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     *
+     * @throws std::runtime_error if the file can not be read.
+     * @see parse_metis_graph()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        void read_metis_file(
+                std::string const& filename,
+                graph::Graph<Id, NodeWeight, EdgeWeight>& graph,
+                size_t thread_cnt=0) {
+            fileutils::MappedFile file(filename);
+            parse_metis_graph(file.begin(), file.end(), graph, thread_cnt);
+        }
+}
+
+/**
+ * Reads a graph in CSR format from \p is.
+ * The format is described in the metis manual in \p deps/metis/manual.
+ * The lines of the graph are read from the stream and then parsed in parallel.
+ * @param is The inputstream.
+ * @param graph The graph to write to.
+ * @returns The input stream.
+ * @see graphio::parse_metis_nodes()
+ */
+template<typename Id, typename NodeWeight, typename EdgeWeight>
+std::istream& operator>>(std::istream& is, graph::Graph<Id, NodeWeight, EdgeWeight>& graph) {
+    std::string line;
+    while (std::getline(is, line) && (line.empty() || line.front() == '%')) {
+        // Skip lines with comments
     }
+    auto const header = graphio::parse_metis_header<Id>(line.data(), line.data() + line.size());
+
+    std::string node_lines;
+    std::vector<std::pair<size_t, size_t>> line_offsets;
+    for (Id curr_node = 0; curr_node < header.node_cnt && std::getline(is, line);) {
+        if (!line.empty() && line.front() == '%') {
+            continue;
+        }
+        line_offsets.emplace_back(node_lines.size(), node_lines.size() + line.size());
+        node_lines += line;
+        node_lines += '\n';
+        ++curr_node;
+    }
+
+    std::vector<graphio::Line> lines;
+    lines.reserve(line_offsets.size());
+    for (auto const& offsets : line_offsets) {
+        lines.emplace_back(node_lines.data() + offsets.first, node_lines.data() + offsets.second);
+    }
+    graph = graph::Graph<Id, NodeWeight, EdgeWeight>(
+            graphio::parse_metis_nodes<Id, NodeWeight, EdgeWeight>(header, lines));
 
     return is;
 }
@@ -278,3 +661,473 @@ std::istream& operator>>(std::istream& is, graphio::ReadSnapFormat<Id, NodeWeigh
 
     return is;
 }
+
+namespace graphio {
+
+    /**
+     * The magic bytes at the start of every graph in the binary format.
+     * The first byte can not start a graph in the METIS format.
+     */
+    static char const BINARY_GRAPH_MAGIC[8] = {'\x89', 'B', 'I', 'N', 'G', 'R', 'P', 'H'};
+
+    /**
+     * The version of the binary graph format which is written.
+     */
+    static uint32_t const BINARY_GRAPH_VERSION = 1;
+
+    /**
+     * The header of a graph in the binary format.
+     * The header is followed by the sections xadj (uint64_t, node_cnt + 1 entries), adjncy (Id),
+     * adjwgt (EdgeWeight), vwgt (NodeWeight) and optionally vrepr_xadj (uint64_t, node_cnt + 1
+     * entries) and vrepr (Id). Every edge is stored in both directions. Each section starts at
+     * an offset which is a multiple of eight bytes, hence the sections can be used in place
+     * if the graph is mapped into memory.
+     */
+    struct BinaryGraphHeader {
+        char magic[8]; /**< Always BINARY_GRAPH_MAGIC. */
+        uint32_t version; /**< The version of the format. */
+        uint32_t byte_order; /**< 0x01020304 written in the byte order of the writer. */
+        uint32_t id_size; /**< The size of an id in bytes. */
+        uint32_t node_weight_size; /**< The size of a node weight in bytes. */
+        uint32_t edge_weight_size; /**< The size of an edge weight in bytes. */
+        uint32_t has_vrepr; /**< Indicates whether the node representatives are stored. */
+        uint64_t node_cnt; /**< The number of nodes. */
+        uint64_t entry_cnt; /**< The number of entries in adjncy. */
+        uint64_t vrepr_cnt; /**< The number of entries in vrepr. */
+        uint64_t record_size; /**< The size of the graph including the header in bytes. */
+    };
+
+    /**
+     * Round \p size up to a multiple of eight.
+     * @param size The size in bytes.
+     * @returns The padded size.
+     */
+    inline uint64_t pad_to_eight(uint64_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+    /**
+     * Checks whether a buffer starts with a graph in the binary format.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @returns True if the buffer starts with the magic bytes of the binary format.
+     */
+    inline bool is_binary_graph(char const* begin, char const* end) {
+        return static_cast<size_t>(end - begin) >= sizeof(BINARY_GRAPH_MAGIC) &&
+            std::equal(begin, begin + sizeof(BINARY_GRAPH_MAGIC), BINARY_GRAPH_MAGIC);
+    }
+
+    /**
+     * A view on a graph in the binary format which is stored in a buffer.
+     * The view does not copy the graph, hence the buffer must outlive the view.
+     * @see BinaryGraphHeader
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct BinaryGraphView {
+            private:
+                BinaryGraphHeader header;
+                char const* begin;
+
+                /**
+                 * Get a pointer to the section starting at \p offset.
+                 * @param offset The offset of the section from the start of the graph.
+                 * @returns The pointer.
+                 */
+                template<typename T>
+                    T const* section(uint64_t offset) const {
+                        return reinterpret_cast<T const*>(this->begin + offset);
+                    }
+
+                /**
+                 * Check that \p offsets are valid offsets into an array of size \p entry_cnt.
+                 * @param offsets The offsets, one per node and one past the last node.
+                 * @param node_cnt The number of nodes.
+                 * @param entry_cnt The size of the array the offsets point into.
+                 * @returns True if the offsets are non-decreasing and bounded by \p entry_cnt.
+                 */
+                static bool is_offset_array(uint64_t const* offsets, uint64_t node_cnt, uint64_t entry_cnt) {
+                    for (uint64_t node = 0; node < node_cnt; ++node) {
+                        if (offsets[node] > offsets[node + 1]) {
+                            return false;
+                        }
+                    }
+                    return offsets[node_cnt] <= entry_cnt;
+                }
+
+                uint64_t adjncy_offset() const {
+                    return sizeof(BinaryGraphHeader) + pad_to_eight((this->header.node_cnt + 1) * sizeof(uint64_t));
+                }
+
+                uint64_t adjwgt_offset() const {
+                    return this->adjncy_offset() + pad_to_eight(this->header.entry_cnt * sizeof(Id));
+                }
+
+                uint64_t vwgt_offset() const {
+                    return this->adjwgt_offset() + pad_to_eight(this->header.entry_cnt * sizeof(EdgeWeight));
+                }
+
+                uint64_t vrepr_xadj_offset() const {
+                    return this->vwgt_offset() + pad_to_eight(this->header.node_cnt * sizeof(NodeWeight));
+                }
+
+                uint64_t vrepr_offset() const {
+                    return this->vrepr_xadj_offset() + pad_to_eight((this->header.node_cnt + 1) * sizeof(uint64_t));
+                }
+
+            public:
+                /**
+                 * Construct a view on the graph at the start of a buffer.
+                 * The buffer must be aligned to eight bytes.
+                 * @param begin The start of the buffer.
+                 * @param end The end of the buffer.
+                 *
+                 * @throws std::invalid_argument if the buffer does not contain a valid graph
+                 *  with the given types.
+                 */
+                BinaryGraphView(char const* begin, char const* end) : begin(begin) {
+                    if (static_cast<size_t>(end - begin) < sizeof(BinaryGraphHeader) ||
+                            !is_binary_graph(begin, end)) {
+                        throw std::invalid_argument("Not a graph in the binary format.");
+                    }
+                    std::memcpy(&this->header, begin, sizeof(BinaryGraphHeader));
+                    if (this->header.version != BINARY_GRAPH_VERSION) {
+                        throw std::invalid_argument("Unsupported version " +
+                                std::to_string(this->header.version) + " of the binary graph format.");
+                    }
+                    if (this->header.byte_order != 0x01020304) {
+                        throw std::invalid_argument("The binary graph was written with a different byte order.");
+                    }
+                    if (this->header.id_size != sizeof(Id) ||
+                            this->header.node_weight_size != sizeof(NodeWeight) ||
+                            this->header.edge_weight_size != sizeof(EdgeWeight)) {
+                        throw std::invalid_argument("The types of the binary graph do not match.");
+                    }
+                    // Every count needs at least one byte in the buffer. Rejecting larger counts first
+                    // keeps the section offsets from overflowing.
+                    uint64_t const buffer_size = static_cast<uint64_t>(end - begin);
+                    if (this->header.node_cnt > buffer_size || this->header.entry_cnt > buffer_size ||
+                            this->header.vrepr_cnt > buffer_size) {
+                        throw std::invalid_argument("The binary graph is truncated.");
+                    }
+                    uint64_t const expected_size = this->header.has_vrepr ?
+                        this->vrepr_offset() + pad_to_eight(this->header.vrepr_cnt * sizeof(Id)) :
+                        this->vrepr_xadj_offset();
+                    if (this->header.record_size != expected_size ||
+                            static_cast<uint64_t>(end - begin) < expected_size) {
+                        throw std::invalid_argument("The binary graph is truncated.");
+                    }
+                    if (this->xadj()[this->header.node_cnt] != this->header.entry_cnt ||
+                            (this->header.has_vrepr &&
+                             this->vrepr_xadj()[this->header.node_cnt] != this->header.vrepr_cnt)) {
+                        throw std::invalid_argument("The binary graph is inconsistent.");
+                    }
+                }
+
+                /** @returns The number of nodes. */
+                uint64_t node_cnt() const { return this->header.node_cnt; }
+                /** @returns The number of entries in adjncy. */
+                uint64_t entry_cnt() const { return this->header.entry_cnt; }
+                /** @returns True if the node representatives are stored. */
+                bool has_vrepr() const { return this->header.has_vrepr != 0; }
+                /** @returns The size of the graph in the buffer in bytes. */
+                uint64_t record_size() const { return this->header.record_size; }
+                /** @returns The offsets into adjncy for each node. */
+                uint64_t const* xadj() const { return this->section<uint64_t>(sizeof(BinaryGraphHeader)); }
+                /** @returns The neighbors of all nodes. */
+                Id const* adjncy() const { return this->section<Id>(this->adjncy_offset()); }
+                /** @returns The weights of the edges in adjncy. */
+                EdgeWeight const* adjwgt() const { return this->section<EdgeWeight>(this->adjwgt_offset()); }
+                /** @returns The node weights. */
+                NodeWeight const* vwgt() const { return this->section<NodeWeight>(this->vwgt_offset()); }
+                /** @returns The offsets into vrepr for each node. Only valid if has_vrepr(). */
+                uint64_t const* vrepr_xadj() const { return this->section<uint64_t>(this->vrepr_xadj_offset()); }
+                /** @returns The representatives of all nodes. Only valid if has_vrepr(). */
+                Id const* vrepr() const { return this->section<Id>(this->vrepr_offset()); }
+
+                /**
+                 * Convert the view into a graph.
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+                 * @returns The graph.
+                 */
+                graph::Graph<Id, NodeWeight, EdgeWeight> to_graph(size_t thread_cnt=0) const {
+                    if (!is_offset_array(this->xadj(), this->node_cnt(), this->entry_cnt()) ||
+                            (this->has_vrepr() &&
+                             !is_offset_array(this->vrepr_xadj(), this->node_cnt(), this->header.vrepr_cnt))) {
+                        throw std::invalid_argument("The binary graph is inconsistent.");
+                    }
+                    graph::WeightedCsrGraph<Id, NodeWeight, EdgeWeight> csr_graph;
+                    csr_graph.xadj.assign(this->xadj(), this->xadj() + this->node_cnt() + 1);
+                    csr_graph.adjncy.assign(this->adjncy(), this->adjncy() + this->entry_cnt());
+                    csr_graph.adjwgt.assign(this->adjwgt(), this->adjwgt() + this->entry_cnt());
+                    csr_graph.vwgt.assign(this->vwgt(), this->vwgt() + this->node_cnt());
+                    for (uint64_t entry_idx = 0; entry_idx < this->entry_cnt(); ++entry_idx) {
+                        if (static_cast<uint64_t>(csr_graph.adjncy[entry_idx]) >= this->node_cnt()) {
+                            throw std::invalid_argument("The binary graph is inconsistent.");
+                        }
+                    }
+
+                    graph::Graph<Id, NodeWeight, EdgeWeight> graph(csr_graph, thread_cnt);
+                    if (this->has_vrepr()) {
+                        for (uint64_t node = 0; node < this->node_cnt(); ++node) {
+                            graph.node_repr(static_cast<Id>(node), typename graph::Graph<Id, NodeWeight, EdgeWeight>::NodeSet(
+                                        this->vrepr() + this->vrepr_xadj()[node],
+                                        this->vrepr() + this->vrepr_xadj()[node + 1]));
+                        }
+                    }
+                    return graph;
+                }
+        };
+
+    /**
+     * Parse a graph in the binary format from a buffer.
+     * If the buffer is not aligned to eight bytes, the graph is copied to an aligned buffer first.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @param graph The graph to write to.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns A pointer past the graph. A following graph can be read from there.
+     * @see BinaryGraphView
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        char const* parse_binary_graph(
+                char const* begin,
+                char const* end,
+                graph::Graph<Id, NodeWeight, EdgeWeight>& graph,
+                size_t thread_cnt=0) {
+            if (reinterpret_cast<uintptr_t>(begin) % 8 != 0) {
+                std::vector<uint64_t> buffer((static_cast<size_t>(end - begin) + 7) / 8);
+                char* const aligned_begin = reinterpret_cast<char*>(buffer.data());
+                std::copy(begin, end, aligned_begin);
+                return begin + (parse_binary_graph(aligned_begin, aligned_begin + (end - begin), graph, thread_cnt)
+                        - aligned_begin);
+            }
+            BinaryGraphView<Id, NodeWeight, EdgeWeight> view(begin, end);
+            graph = view.to_graph(thread_cnt);
+            return begin + view.record_size();
+        }
+
+    /**
+     * Skip empty lines and comment lines, i.e. lines starting with '%', as they may occur between graphs.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @returns A pointer to the first line which is neither empty nor a comment.
+     */
+    inline char const* skip_comment_lines(char const* begin, char const* end) {
+        char const* pos = begin;
+        while (pos != end && (*pos == '\n' || *pos == '%')) {
+            char const* const line_end = find_line_end(pos, end);
+            pos = (line_end == end) ? end : line_end + 1;
+        }
+        return pos;
+    }
+
+    /**
+     * Parse a graph in the binary or the METIS format from a buffer.
+     * The format is detected with the magic bytes of the binary format.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @param graph The graph to write to.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns A pointer past the graph.
+     * @see parse_binary_graph()
+     * @see parse_metis_graph()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        char const* parse_graph(
+                char const* begin,
+                char const* end,
+                graph::Graph<Id, NodeWeight, EdgeWeight>& graph,
+                size_t thread_cnt=0) {
+            begin = skip_comment_lines(begin, end);
+            if (is_binary_graph(begin, end)) {
+                return parse_binary_graph(begin, end, graph, thread_cnt);
+            } else {
+                return parse_metis_graph(begin, end, graph, thread_cnt);
+            }
+        }
+
+    /**
+     * Find the end of the graph in the binary or the METIS format at the start of a buffer
+     * without parsing the nodes.
+     * @param begin The start of the buffer.
+     * @param end The end of the buffer.
+     * @returns A pointer past the graph.
+     *
+     * @throws std::invalid_argument if the graph is truncated or its header is malformed.
+     * @see parse_graph()
+     */
+    template<typename Id>
+        char const* find_graph_end(char const* begin, char const* end) {
+            begin = skip_comment_lines(begin, end);
+            if (is_binary_graph(begin, end)) {
+                BinaryGraphHeader header;
+                if (static_cast<size_t>(end - begin) < sizeof(header)) {
+                    throw std::invalid_argument("The binary graph is truncated.");
+                }
+                std::memcpy(&header, begin, sizeof(header));
+                if (header.record_size > static_cast<uint64_t>(end - begin)) {
+                    throw std::invalid_argument("The binary graph is truncated.");
+                }
+                return begin + header.record_size;
+            } else {
+                return split_metis_graph<Id>(begin, end, [](Line const&){}).second;
+            }
+        }
+
+    /**
+     * Writer for graphs in the binary format.
+     * @see BinaryGraphHeader
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct WriteBinaryFormat {
+            graph::Graph<Id, NodeWeight, EdgeWeight> const& graph;
+
+            /**
+             * Construct a writer.
+             * The node representatives are only written if a node does not represent exactly itself.
+             * @param graph The graph to write.
+             */
+            WriteBinaryFormat(graph::Graph<Id, NodeWeight, EdgeWeight> const& graph) :
+                graph(graph) {}
+        };
+
+    /**
+     * Reader for graphs in the binary format.
+     * @see BinaryGraphHeader
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct ReadBinaryFormat {
+            graph::Graph<Id, NodeWeight, EdgeWeight>& graph;
+
+            /**
+             * Construct a reader.
+             * @param graph The graph to read into.
+             */
+            ReadBinaryFormat(graph::Graph<Id, NodeWeight, EdgeWeight>& graph) :
+                graph(graph) {}
+        };
+
+    /**
+     * Write the zeros which pad \p size bytes to a multiple of eight bytes.
+     * @param os The output stream.
+     * @param size The number of bytes which were written.
+     */
+    inline void write_padding(std::ostream& os, uint64_t size) {
+        static char const zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        os.write(zeros, static_cast<std::streamsize>(pad_to_eight(size) - size));
+    }
+
+    /**
+     * Write \p size bytes and pad them with zeros to a multiple of eight bytes.
+     * @param os The output stream.
+     * @param data The data to write.
+     * @param size The number of bytes.
+     */
+    inline void write_padded(std::ostream& os, void const* data, uint64_t size) {
+        os.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+        write_padding(os, size);
+    }
+}
+
+/**
+ * Write a graph in the binary format.
+ * @param os The output stream.
+ * @param write The writer.
+ * @returns The output stream.
+ */
+template<typename Id, typename NodeWeight, typename EdgeWeight>
+std::ostream& operator<<(std::ostream& os, graphio::WriteBinaryFormat<Id, NodeWeight, EdgeWeight> const& write) {
+    auto const& graph = write.graph;
+    auto const csr_graph = graph.to_weighted_csr_graph();
+    uint64_t const node_cnt = static_cast<uint64_t>(graph.node_cnt());
+
+    std::vector<uint64_t> xadj(csr_graph.xadj.cbegin(), csr_graph.xadj.cend());
+    std::vector<uint64_t> vrepr_xadj(1, 0);
+    std::vector<Id> vrepr;
+    bool has_vrepr = false;
+    for (Id node = 0; node < graph.node_cnt(); ++node) {
+        auto const node_repr = graph.node_repr(node);
+        has_vrepr = has_vrepr || node_repr.size() != 1 || *node_repr.cbegin() != node;
+        vrepr.insert(vrepr.end(), node_repr.cbegin(), node_repr.cend());
+        vrepr_xadj.push_back(vrepr.size());
+    }
+
+    graphio::BinaryGraphHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::copy(graphio::BINARY_GRAPH_MAGIC, graphio::BINARY_GRAPH_MAGIC + 8, header.magic);
+    header.version = graphio::BINARY_GRAPH_VERSION;
+    header.byte_order = 0x01020304;
+    header.id_size = sizeof(Id);
+    header.node_weight_size = sizeof(NodeWeight);
+    header.edge_weight_size = sizeof(EdgeWeight);
+    header.has_vrepr = has_vrepr ? 1 : 0;
+    header.node_cnt = node_cnt;
+    header.entry_cnt = csr_graph.adjncy.size();
+    header.vrepr_cnt = has_vrepr ? vrepr.size() : 0;
+    header.record_size = sizeof(header) +
+        graphio::pad_to_eight((node_cnt + 1) * sizeof(uint64_t)) +
+        graphio::pad_to_eight(header.entry_cnt * sizeof(Id)) +
+        graphio::pad_to_eight(header.entry_cnt * sizeof(EdgeWeight)) +
+        graphio::pad_to_eight(node_cnt * sizeof(NodeWeight));
+    if (has_vrepr) {
+        header.record_size += graphio::pad_to_eight((node_cnt + 1) * sizeof(uint64_t)) +
+            graphio::pad_to_eight(header.vrepr_cnt * sizeof(Id));
+    }
+
+    os.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    graphio::write_padded(os, xadj.data(), xadj.size() * sizeof(uint64_t));
+    graphio::write_padded(os, csr_graph.adjncy.data(), csr_graph.adjncy.size() * sizeof(Id));
+    graphio::write_padded(os, csr_graph.adjwgt.data(), csr_graph.adjwgt.size() * sizeof(EdgeWeight));
+    graphio::write_padded(os, csr_graph.vwgt.data(), csr_graph.vwgt.size() * sizeof(NodeWeight));
+    if (has_vrepr) {
+        graphio::write_padded(os, vrepr_xadj.data(), vrepr_xadj.size() * sizeof(uint64_t));
+        graphio::write_padded(os, vrepr.data(), vrepr.size() * sizeof(Id));
+    }
+    return os;
+}
+
+/**
+ * Read a graph in the binary format.
+ * The graph is read into an aligned buffer first.
+ * @param is The input stream.
+ * @param read The reader.
+ * @returns The input stream.
+ */
+template<typename Id, typename NodeWeight, typename EdgeWeight>
+std::istream& operator>>(std::istream& is, graphio::ReadBinaryFormat<Id, NodeWeight, EdgeWeight>& read) {
+    graphio::BinaryGraphHeader header;
+    if (!is.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::invalid_argument("Not a graph in the binary format.");
+    }
+
+    std::vector<uint64_t> buffer(std::max(header.record_size, static_cast<uint64_t>(sizeof(header))) / 8);
+    char* const begin = reinterpret_cast<char*>(buffer.data());
+    std::memcpy(begin, &header, sizeof(header));
+    uint64_t const remaining = buffer.size() * 8 - sizeof(header);
+    if (!graphio::is_binary_graph(begin, begin + sizeof(header)) ||
+            !is.read(begin + sizeof(header), static_cast<std::streamsize>(remaining))) {
+        throw std::invalid_argument("Not a graph in the binary format.");
+    }
+    graphio::parse_binary_graph(begin, begin + buffer.size() * 8, read.graph);
+    return is;
+}
+
+namespace graphio {
+
+    /**
+     * Read a graph in the binary or the METIS format from a stream.
+     * The format is detected with the first byte of the magic bytes of the binary format.
+     * @param is The input stream.
+     * @param graph The graph to write to.
+     * @returns The input stream.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::istream& read_graph(std::istream& is, graph::Graph<Id, NodeWeight, EdgeWeight>& graph) {
+            if (is.peek() == static_cast<unsigned char>(BINARY_GRAPH_MAGIC[0])) {
+                ReadBinaryFormat<Id, NodeWeight, EdgeWeight> read(graph);
+                return is >> read;
+            } else {
+                return is >> graph;
+            }
+        }
+}
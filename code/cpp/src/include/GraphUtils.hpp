@@ -7,12 +7,22 @@
 #pragma once 
 
 #include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cmath>
+#include<cstdint>
+#include<functional>
+#include<future>
+#include<limits>
 #include<queue>
 #include<random>
 #include<tuple>
+#include<unordered_map>
 #include<vector>
 
 #include "Graph.hpp"
+#include "ParallelUtils.hpp"
+#include "Refine.hpp"
 
 namespace graph {
 
@@ -93,12 +103,15 @@ namespace graph {
      * to which the edge weight is the highest.
      * @param graph The graph to perform to search the matching in.
      * @param seed The seed to use to traverse the nodes randomly (default 0).
+     * @param max_node_weight Two nodes are only matched if their combined weight is at most this
+     *  (default no bound).
      * @returns The matching.
      */
     template<typename Id, typename NodeWeight, typename EdgeWeight, typename RandGen=std::mt19937_64>
         typename Graph<Id, NodeWeight, EdgeWeight>::Matching heavy_edge_matching(
                 Graph<Id, NodeWeight, EdgeWeight> const& graph,
-                size_t seed=0
+                size_t seed=0,
+                NodeWeight max_node_weight=std::numeric_limits<NodeWeight>::max()
                 ) {
 
             std::vector<Id> visit_order(graph.node_cnt());
@@ -135,7 +148,8 @@ namespace graph {
                 };
                 std::sort(inc_edges.begin(), inc_edges.end(), comp);
                 for (Edge edge : inc_edges) {
-                    if (!is_matched.at(edge.first) && node != edge.first) {
+                    if (!is_matched.at(edge.first) && node != edge.first &&
+                            graph.node_weight(node) <= max_node_weight - graph.node_weight(edge.first)) {
                         matching.push_back(std::make_pair(node, edge.first));
                         is_matched[node] = true;
                         is_matched[edge.first] = true;
@@ -146,6 +160,81 @@ namespace graph {
             return matching;
         }
 
+    /**
+     * Extend \p matching by pairs of unmatched nodes which have a common neighbor, like the two-hop
+     * matching of METIS. The leaves of a hub have no edge between them, hence without these pairs a
+     * star shrinks by only one node per matching. The pairs are not adjacent, so the result is no
+     * matching in the strict sense, but it can be contracted like one.
+     * @param graph The graph of the matching.
+     * @param matching The matching to extend.
+     * @param max_node_weight Two nodes are only paired if their combined weight is at most this.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        void extend_two_hop_matching(
+                Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                typename Graph<Id, NodeWeight, EdgeWeight>::Matching& matching,
+                NodeWeight max_node_weight) {
+            std::vector<bool> is_matched(static_cast<size_t>(graph.node_cnt()), false);
+            for (auto const& edge : matching) {
+                is_matched[static_cast<size_t>(edge.first)] = true;
+                is_matched[static_cast<size_t>(edge.second)] = true;
+            }
+
+            for (Id node = 0; node < graph.node_cnt(); ++node) {
+                // The lightest unmatched neighbor which still waits for a partner.
+                Id waiting = -1;
+                for (auto const& edge : graph.inc_edges(node)) {
+                    Id const neighbor = edge.first;
+                    if (neighbor == node || is_matched[static_cast<size_t>(neighbor)]) {
+                        continue;
+                    }
+                    if (waiting < 0) {
+                        waiting = neighbor;
+                    } else if (graph.node_weight(waiting) <= max_node_weight - graph.node_weight(neighbor)) {
+                        matching.push_back(std::make_pair(waiting, neighbor));
+                        is_matched[static_cast<size_t>(waiting)] = true;
+                        is_matched[static_cast<size_t>(neighbor)] = true;
+                        waiting = -1;
+                    } else if (graph.node_weight(neighbor) < graph.node_weight(waiting)) {
+                        waiting = neighbor;
+                    }
+                }
+            }
+        }
+
+    /**
+     * Contract all edges with weight \p infty in \p graph.
+     * The connected components of these edges are found with a union-find structure and
+     * contracted at once. The contracted nodes are numbered by the smallest node they contain.
+     * @param graph The graph to contract. This graph is changed.
+     * @param infty The value to treat as infinity.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        void contract_inf_edges(Graph<Id, NodeWeight, EdgeWeight>& graph, EdgeWeight infty) {
+            UnionFind<Id> union_find(graph.node_cnt());
+            for (Id node = 0; node < graph.node_cnt(); ++node) {
+                for (auto const& edge : graph.inc_edges(node)) {
+                    if (edge.second == infty && edge.first > node) {
+                        union_find.union_(node, edge.first);
+                    }
+                }
+            }
+
+            Id const no_label = std::numeric_limits<Id>::max();
+            std::vector<Id> root_label(static_cast<size_t>(graph.node_cnt()), no_label);
+            std::vector<Id> node_labels(static_cast<size_t>(graph.node_cnt()));
+            Id label_cnt = 0;
+            for (Id node = 0; node < graph.node_cnt(); ++node) {
+                Id const root = union_find.find(node);
+                if (root_label[static_cast<size_t>(root)] == no_label) {
+                    root_label[static_cast<size_t>(root)] = label_cnt;
+                    label_cnt += 1;
+                }
+                node_labels[static_cast<size_t>(node)] = root_label[static_cast<size_t>(root)];
+            }
+            graph.contract_nodes(node_labels, label_cnt);
+        }
+
     /**
      * Contract \p graph to \p node_cnt nodes by iteratively contracting edges.
      * The edges to contract are found using heavy edge matching.
@@ -180,87 +269,827 @@ namespace graph {
             }
 
     /**
-     * Find the MST of a graph using Kruskals algorithm.
+     * Mix the bits of a 64 bit integer.
+     * This is the finalizer of the SplitMix64 generator and is used to derive random
+     * priorities from edges without a sequential random generator.
+     * @param value The value to mix.
+     * @returns The mixed value.
+     */
+    inline uint64_t mix_bits(uint64_t value) {
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * Compute a spanning tree of \p graph with the algorithm of Boruvka.
+     * The edges are ordered by the key returned by \p edge_key and ties are broken by the ids
+     * of the end nodes. Since this order is strict the resulting minimum spanning forest is
+     * unique and equals the one found by Kruskals algorithm.
+     * In every round each node determines its lightest edge leaving its component in parallel.
+     * Afterwards the components are merged along the lightest edges. If \p graph is
+     * disconnected the trees of the spanning forest are connected with edges of weight zero.
      * @param graph The graph.
-     * @returns The MST.
+     * @param edge_key A function which maps an edge given as (from, to, weight) with from < to
+     *  to its key.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The spanning tree which has the same nodes as \p graph.
      */
-    template<typename Id, typename NodeWeight, typename EdgeWeight>
-        Graph<Id, NodeWeight, EdgeWeight> mst(
-                Graph<Id, NodeWeight, EdgeWeight> const& graph) {
-            Graph<Id, NodeWeight, EdgeWeight> mst_graph(graph.node_cnt());
-
-            using Edge = std::tuple<EdgeWeight, Id, Id>;
-            std::priority_queue<Edge,
-                std::vector<Edge>, std::greater<Edge>> prio_q;
-            for (auto const& edge : graph.edge_set()) {
-                prio_q.emplace(std::get<2>(edge), std::get<0>(edge), std::get<1>(edge));
+    template<typename Id, typename NodeWeight, typename EdgeWeight, typename EdgeKey>
+        Graph<Id, NodeWeight, EdgeWeight> boruvka_spanning_tree(
+                Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                EdgeKey edge_key,
+                size_t thread_cnt=0) {
+
+            using Key = decltype(edge_key(Id(), Id(), EdgeWeight()));
+            using EdgeOrder = std::tuple<Key, Id, Id>;
+
+            auto const csr_graph = graph.to_weighted_csr_graph(thread_cnt);
+            Id const node_cnt = graph.node_cnt();
+            size_t const node_cnt_st = static_cast<size_t>(node_cnt);
+
+            Graph<Id, NodeWeight, EdgeWeight> tree_graph(node_cnt);
+            for (Id node = 0; node < node_cnt; ++node) {
+                tree_graph.node_weight(node, graph.node_weight(node));
+                tree_graph.node_repr(node, graph.node_repr(node));
             }
 
-            UnionFind<Id> union_find(graph.node_cnt());
-            while(!prio_q.empty()) {
-                EdgeWeight edge_weight;
-                Id from_node;
-                Id to_node;
-                std::tie(edge_weight, from_node, to_node) = prio_q.top();
-                prio_q.pop();
-                
-                if (union_find.find(from_node) != union_find.find(to_node)) {
-                    mst_graph.edge_weight(from_node, to_node, edge_weight);
-                    union_find.union_(from_node, to_node);
+            auto edge_order = [&csr_graph, &edge_key](Id from_node, size_t edge_idx){
+                Id const to_node = csr_graph.adjncy[edge_idx];
+                Id const low_node = std::min(from_node, to_node);
+                Id const high_node = std::max(from_node, to_node);
+                return EdgeOrder(edge_key(low_node, high_node, csr_graph.adjwgt[edge_idx]),
+                        low_node, high_node);
+            };
+
+            size_t const no_edge = std::numeric_limits<size_t>::max();
+            std::vector<Id> comp(node_cnt_st);
+            for (Id node = 0; node < node_cnt; ++node) {
+                comp[static_cast<size_t>(node)] = node;
+            }
+            std::vector<size_t> node_best(node_cnt_st);
+            std::vector<EdgeOrder> node_best_order(node_cnt_st);
+            std::vector<Id> comp_best_node(node_cnt_st);
+            std::vector<size_t> comp_best(node_cnt_st);
+
+            UnionFind<Id> union_find(node_cnt);
+            bool has_merged = true;
+            while (has_merged) {
+                parutils::parallel_for(node_cnt_st, thread_cnt, [&](size_t node){
+                        node_best[node] = no_edge;
+                        for (size_t edge_idx = csr_graph.xadj[node];
+                                edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                            if (comp[static_cast<size_t>(csr_graph.adjncy[edge_idx])] == comp[node]) {
+                                continue;
+                            }
+                            EdgeOrder const order = edge_order(static_cast<Id>(node), edge_idx);
+                            if (node_best[node] == no_edge || order < node_best_order[node]) {
+                                node_best[node] = edge_idx;
+                                node_best_order[node] = order;
+                            }
+                        }
+                        });
+
+                std::fill(comp_best.begin(), comp_best.end(), no_edge);
+                for (size_t node = 0; node < node_cnt_st; ++node) {
+                    if (node_best[node] == no_edge) {
+                        continue;
+                    }
+                    size_t const node_comp = static_cast<size_t>(comp[node]);
+                    if (comp_best[node_comp] == no_edge || node_best_order[node] <
+                            node_best_order[static_cast<size_t>(comp_best_node[node_comp])]) {
+                        comp_best[node_comp] = node_best[node];
+                        comp_best_node[node_comp] = static_cast<Id>(node);
+                    }
+                }
+
+                has_merged = false;
+                for (size_t node_comp = 0; node_comp < node_cnt_st; ++node_comp) {
+                    if (comp_best[node_comp] == no_edge) {
+                        continue;
+                    }
+                    Id const from_node = comp_best_node[node_comp];
+                    Id const to_node = csr_graph.adjncy[comp_best[node_comp]];
+                    // Both components may have chosen the same edge.
+                    if (union_find.find(from_node) != union_find.find(to_node)) {
+                        union_find.union_(from_node, to_node);
+                        tree_graph.edge_weight(from_node, to_node, csr_graph.adjwgt[comp_best[node_comp]]);
+                        has_merged = true;
+                    }
+                }
+
+                for (Id node = 0; node < node_cnt; ++node) {
+                    comp[static_cast<size_t>(node)] = union_find.find(node);
                 }
             }
 
             std::vector<Id> roots = union_find.roots();
             for (Id root_idx = 1; root_idx < roots.size(); ++root_idx) {
-                mst_graph.edge_weight(roots[0], roots[root_idx], 0);
+                tree_graph.edge_weight(roots[0], roots[root_idx], 0);
             }
 
-            return mst_graph;
+            return tree_graph;
+        }
+
+    /**
+     * Find the MST of a graph using the algorithm of Boruvka.
+     * Edges with equal weight are ordered by their end nodes.
+     * @param graph The graph.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The MST.
+     * @see graph::boruvka_spanning_tree()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        Graph<Id, NodeWeight, EdgeWeight> mst(
+                Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                size_t thread_cnt=0) {
+            return boruvka_spanning_tree(graph,
+                    [](Id, Id, EdgeWeight edge_weight){ return edge_weight; }, thread_cnt);
         }
 
     /**
      * Calculates a Random Spanning Tree (RST) on \p graph.
+     * This is the minimum spanning tree with respect to random edge priorities.
+     * The priority of an edge is derived from its end nodes and \p seed, hence the priorities
+     * can be computed in parallel.
      * @param graph The graph to use.
      * @param seed The seed for the random generator (default 0).
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
      * @returns The RST
+     * @see graph::boruvka_spanning_tree()
      */
     template<typename Id, typename NodeWeight, typename EdgeWeight,
         typename RandGen=std::mt19937_64>
             Graph<Id, NodeWeight, EdgeWeight> rst(
                     Graph<Id, NodeWeight, EdgeWeight> const& graph,
-                    size_t seed=0) {
+                    size_t seed=0,
+                    size_t thread_cnt=0) {
 
                 RandGen rand_gen(seed);
+                uint64_t const salt = static_cast<uint64_t>(rand_gen());
 
-                Graph<Id, NodeWeight, EdgeWeight> rst_graph(graph.node_cnt());
+                return boruvka_spanning_tree(graph,
+                        [salt](Id from_node, Id to_node, EdgeWeight){
+                        return mix_bits(mix_bits(salt ^ static_cast<uint64_t>(from_node)) ^
+                                static_cast<uint64_t>(to_node));
+                        }, thread_cnt);
+            }
 
-                using Edge = std::tuple<size_t, Id, Id>;
-                std::priority_queue<Edge,
-                    std::vector<Edge>, std::greater<Edge>> prio_q;
-                for (auto const& edge : graph.edge_set()) {
-                    prio_q.emplace(rand_gen(), std::get<0>(edge), std::get<1>(edge));
+    /**
+     * Build a tree from the parent of each node.
+     * The first nodes of the tree get the weights in \p leaf_weights, all other nodes have
+     * weight zero.
+     * @param parent The parent of each node or -1 for the root.
+     * @param parent_weight The weight of the edge from each node to its parent.
+     * @param leaf_weights The weights of the first nodes.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The tree.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        Graph<Id, NodeWeight, EdgeWeight> tree_from_parents(
+                std::vector<Id> const& parent,
+                std::vector<EdgeWeight> const& parent_weight,
+                std::vector<NodeWeight> const& leaf_weights,
+                size_t thread_cnt=0) {
+            size_t const tree_node_cnt = parent.size();
+            WeightedCsrGraph<Id, NodeWeight, EdgeWeight> tree;
+            tree.vwgt.assign(tree_node_cnt, 0);
+            std::copy(leaf_weights.cbegin(), leaf_weights.cend(), tree.vwgt.begin());
+            tree.xadj.assign(tree_node_cnt + 1, 0);
+            for (size_t node = 0; node < tree_node_cnt; ++node) {
+                if (parent[node] >= 0) {
+                    tree.xadj[node + 1] += 1;
+                    tree.xadj[static_cast<size_t>(parent[node]) + 1] += 1;
+                }
+            }
+            for (size_t node = 0; node < tree_node_cnt; ++node) {
+                tree.xadj[node + 1] += tree.xadj[node];
+            }
+            std::vector<size_t> fill(tree.xadj.cbegin(), tree.xadj.cend() - 1);
+            tree.adjncy.resize(tree.xadj.back());
+            tree.adjwgt.resize(tree.xadj.back());
+            for (size_t node = 0; node < tree_node_cnt; ++node) {
+                if (parent[node] >= 0) {
+                    size_t const parent_node = static_cast<size_t>(parent[node]);
+                    tree.adjncy[fill[node]] = parent[node];
+                    tree.adjwgt[fill[node]++] = parent_weight[node];
+                    tree.adjncy[fill[parent_node]] = static_cast<Id>(node);
+                    tree.adjwgt[fill[parent_node]++] = parent_weight[node];
                 }
+            }
+            return Graph<Id, NodeWeight, EdgeWeight>(tree, thread_cnt);
+        }
 
-                UnionFind<Id> union_find(graph.node_cnt());
-                while(!prio_q.empty()) {
-                    size_t priority;
-                    Id from_node;
-                    Id to_node;
-                    std::tie(priority, from_node, to_node) = prio_q.top();
-                    prio_q.pop();
+    /**
+     * Builds a decomposition tree by recursive bisection.
+     * The nodes of the graph are kept in an array in which every cluster is a contiguous range.
+     * A cluster is bisected with METIS and the halves are moved to the front and the back of its
+     * range. Since every position between two nodes is the split point of exactly one cluster,
+     * the cluster split at position \p mid gets the id <code>node_cnt + mid - 1</code>. Hence the
+     * ids do not depend on the order in which the clusters are processed.
+     * @see graph::decomposition_tree()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        struct RecursiveBisection {
+            private:
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph; /**< The graph. */
+                real_t const imbalance; /**< The imbalance of a bisection as expected by METIS. */
+                std::vector<Id> order; /**< The nodes ordered such that every cluster is a range. */
+                std::vector<std::atomic<uint64_t>> cluster_key; /**< Identifies the current cluster of a node. */
+                std::vector<idx_t> local_id; /**< The id of a node in its current cluster. */
 
-                    if (union_find.find(from_node) != union_find.find(to_node)) {
-                        rst_graph.edge_weight(from_node, to_node,
-                                graph.edge_weight(from_node, to_node));
-                        union_find.union_(from_node, to_node);
+            public:
+                std::vector<Id> parent; /**< The parent of each node of the tree. */
+                std::vector<EdgeWeight> parent_weight; /**< The weight of the edge to the parent. */
+
+                /**
+                 * Constructor.
+                 * @param csr_graph The graph.
+                 * @param imbalance The maximum imbalance of a bisection.
+                 */
+                RecursiveBisection(WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph,
+                        Rational const& imbalance) :
+                    csr_graph(csr_graph), imbalance(static_cast<real_t>(1 + imbalance.get_d())),
+                    order(csr_graph.vwgt.size()), cluster_key(csr_graph.vwgt.size()),
+                    local_id(csr_graph.vwgt.size()),
+                    parent(std::max(2 * csr_graph.vwgt.size(), static_cast<size_t>(2)) - 1, -1),
+                    parent_weight(parent.size(), 0) {
+                        for (size_t node = 0; node < this->order.size(); ++node) {
+                            this->order[node] = static_cast<Id>(node);
+                        }
+                    }
+
+                /**
+                 * Decompose the cluster at the positions [\p begin, \p end) of the order.
+                 * Clusters with at least parutils::MIN_BLOCK_SIZE nodes are decomposed in parallel
+                 * as long as \p parallel_depth is positive.
+                 * @param begin The begin of the cluster.
+                 * @param end The end of the cluster.
+                 * @param parent_id The id of the parent cluster or -1 for the root.
+                 * @param parallel_depth The number of levels which may still be run in parallel.
+                 */
+                void split(size_t begin, size_t end, Id parent_id, size_t parallel_depth) {
+                    // The nodes of a sibling may still carry the key of the parent, hence the key
+                    // depends on both ends of the range.
+                    uint64_t const key = static_cast<uint64_t>(begin) * (this->order.size() + 1) + end;
+                    for (size_t pos = begin; pos < end; ++pos) {
+                        size_t const node = static_cast<size_t>(this->order[pos]);
+                        this->cluster_key[node].store(key, std::memory_order_relaxed);
+                        this->local_id[node] = static_cast<idx_t>(pos - begin);
+                    }
+
+                    // Collect the edges inside the cluster without self loops and the cut weight.
+                    EdgeWeight boundary = 0;
+                    std::vector<idx_t> xadj(1, 0);
+                    std::vector<idx_t> adjncy;
+                    std::vector<idx_t> vwgt;
+                    std::vector<idx_t> adjwgt;
+                    xadj.reserve(end - begin + 1);
+                    vwgt.reserve(end - begin);
+                    for (size_t pos = begin; pos < end; ++pos) {
+                        size_t const node = static_cast<size_t>(this->order[pos]);
+                        for (size_t edge_idx = this->csr_graph.xadj[node];
+                                edge_idx < this->csr_graph.xadj[node + 1]; ++edge_idx) {
+                            size_t const to_node = static_cast<size_t>(this->csr_graph.adjncy[edge_idx]);
+                            if (to_node == node) {
+                                continue;
+                            }
+                            if (this->cluster_key[to_node].load(std::memory_order_relaxed) == key) {
+                                adjncy.push_back(this->local_id[to_node]);
+                                adjwgt.push_back(static_cast<idx_t>(this->csr_graph.adjwgt[edge_idx]));
+                            } else {
+                                boundary += this->csr_graph.adjwgt[edge_idx];
+                            }
+                        }
+                        xadj.push_back(static_cast<idx_t>(adjncy.size()));
+                        vwgt.push_back(static_cast<idx_t>(this->csr_graph.vwgt[node]));
+                    }
+
+                    Id cluster_id;
+                    if (end - begin == 1) {
+                        cluster_id = this->order[begin];
+                    } else {
+                        std::vector<idx_t> part;
+                        if (!adjncy.empty()) {
+                            part = MetisCsrGraph(xadj, adjncy, vwgt, adjwgt)
+                                .part_graph_recursive(2, this->imbalance).second;
+                        }
+                        size_t const first_cnt = static_cast<size_t>(std::count(part.cbegin(), part.cend(), 0));
+                        if (first_cnt == 0 || first_cnt == end - begin) {
+                            // Without edges or a proper bisection the cluster is split in the middle.
+                            part.assign(end - begin, 1);
+                            std::fill(part.begin(), part.begin() + static_cast<std::ptrdiff_t>((end - begin) / 2), 0);
+                        }
+                        std::stable_partition(this->order.begin() + static_cast<std::ptrdiff_t>(begin),
+                                this->order.begin() + static_cast<std::ptrdiff_t>(end),
+                                [this, &part](Id node){
+                                return part[static_cast<size_t>(this->local_id[static_cast<size_t>(node)])] == 0;
+                                });
+                        size_t const mid = begin + static_cast<size_t>(std::count(part.cbegin(), part.cend(), 0));
+                        cluster_id = static_cast<Id>(this->order.size() + mid - 1);
+
+                        if (parallel_depth > 0 && end - begin >= parutils::MIN_BLOCK_SIZE) {
+                            auto first_half = std::async(std::launch::async, [this, begin, mid, cluster_id, parallel_depth](){
+                                    this->split(begin, mid, cluster_id, parallel_depth - 1);
+                                    });
+                            this->split(mid, end, cluster_id, parallel_depth - 1);
+                            first_half.get();
+                        } else {
+                            this->split(begin, mid, cluster_id, 0);
+                            this->split(mid, end, cluster_id, 0);
+                        }
+                    }
+                    this->parent[static_cast<size_t>(cluster_id)] = parent_id;
+                    this->parent_weight[static_cast<size_t>(cluster_id)] = boundary;
+                }
+        };
+
+    /**
+     * Build a hierarchical decomposition tree of \p graph by recursive bisection.
+     * The nodes 0 to n-1 of the tree are the leaves and correspond to the n nodes of \p graph.
+     * They have the same weights as in \p graph. The other nodes are the clusters found by the
+     * bisections and have weight zero. The edge from a cluster to its parent has the weight of
+     * the edges between the cluster and the rest of the graph. \n
+     * Each bisection is computed with the multilevel recursive method of METIS. The two halves
+     * of a cluster are decomposed concurrently.
+     * @param graph The graph.
+     * @param imbalance The maximum imbalance of each bisection (default 1/10).
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The decomposition tree with 2n-1 nodes.
+     * @see graph::RecursiveBisection
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        Graph<Id, NodeWeight, EdgeWeight> decomposition_tree(
+                Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                Rational const& imbalance=Rational(1, 10),
+                size_t thread_cnt=0) {
+            if (graph.node_cnt() == 0) {
+                return Graph<Id, NodeWeight, EdgeWeight>();
+            }
+
+            WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const csr_graph = graph.to_weighted_csr_graph(thread_cnt);
+            RecursiveBisection<Id, NodeWeight, EdgeWeight> bisection(csr_graph, imbalance);
+            size_t parallel_depth = 0;
+            for (size_t leaf_cnt = 1; leaf_cnt < parutils::get_thread_cnt(thread_cnt); leaf_cnt *= 2) {
+                parallel_depth += 1;
+            }
+            bisection.split(0, csr_graph.vwgt.size(), -1, parallel_depth);
+
+            return tree_from_parents<Id, NodeWeight, EdgeWeight>(
+                    bisection.parent, bisection.parent_weight, csr_graph.vwgt, thread_cnt);
+        }
+
+    /**
+     * An entry of a least-element list.
+     * @see graph::least_element_lists()
+     */
+    template<typename Id>
+        struct LeastElement {
+            Id center; /**< The center. */
+            double distance; /**< The distance to the center. */
+        };
+
+    /**
+     * Compute the least-element lists of all nodes for the order \p order of the centers.
+     * The list of a node contains every center which is strictly closer to it than all centers
+     * before it in \p order. The entries are sorted by \p order, hence the distances decrease. \n
+     * The centers are processed in batches of doubling size. The searches of a batch run in
+     * parallel and are only pruned with the lists of the previous batches. Afterwards the
+     * results of the batch are merged in order.
+     * @param csr_graph The graph.
+     * @param edge_length The length of each entry in the adjacency of \p csr_graph.
+     * @param order The order of the centers, a permutation of the nodes.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The list of each node.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::vector<std::vector<LeastElement<Id>>> least_element_lists(
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph,
+                std::vector<double> const& edge_length,
+                std::vector<Id> const& order,
+                size_t thread_cnt=0) {
+            size_t const node_cnt = csr_graph.vwgt.size();
+            std::vector<std::vector<LeastElement<Id>>> lists(node_cnt);
+            std::vector<double> best(node_cnt, std::numeric_limits<double>::infinity());
+
+            for (size_t batch_begin = 0, batch_size = 1; batch_begin < node_cnt;
+                    batch_begin += batch_size, batch_size *= 2) {
+                size_t const batch_end = std::min(batch_begin + batch_size, node_cnt);
+                std::vector<std::vector<std::pair<Id, double>>> reached(batch_end - batch_begin);
+
+                parutils::parallel_for_dynamic(batch_end - batch_begin, thread_cnt,
+                        [&](size_t search_idx){
+                        using QueueEntry = std::pair<double, Id>;
+                        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+                        std::unordered_map<Id, double> distance;
+                        Id const center = order[batch_begin + search_idx];
+                        queue.emplace(0.0, center);
+                        distance[center] = 0.0;
+                        while (!queue.empty()) {
+                            double const node_distance = queue.top().first;
+                            Id const node = queue.top().second;
+                            queue.pop();
+                            if (node_distance > distance[node] ||
+                                    node_distance >= best[static_cast<size_t>(node)]) {
+                                continue;
+                            }
+                            reached[search_idx].emplace_back(node, node_distance);
+                            for (size_t edge_idx = csr_graph.xadj[static_cast<size_t>(node)];
+                                    edge_idx < csr_graph.xadj[static_cast<size_t>(node) + 1]; ++edge_idx) {
+                                Id const to_node = csr_graph.adjncy[edge_idx];
+                                double const to_distance = node_distance + edge_length[edge_idx];
+                                auto const it = distance.find(to_node);
+                                if (to_distance < best[static_cast<size_t>(to_node)] &&
+                                        (it == distance.end() || to_distance < it->second)) {
+                                    distance[to_node] = to_distance;
+                                    queue.emplace(to_distance, to_node);
+                                }
+                            }
+                        }
+                        });
+
+                for (size_t search_idx = 0; search_idx < reached.size(); ++search_idx) {
+                    Id const center = order[batch_begin + search_idx];
+                    for (auto const& entry : reached[search_idx]) {
+                        size_t const node = static_cast<size_t>(entry.first);
+                        if (entry.second < best[node]) {
+                            best[node] = entry.second;
+                            lists[node].push_back(LeastElement<Id>{center, entry.second});
+                        }
                     }
                 }
+            }
+            return lists;
+        }
+
+    /**
+     * Build a tree embedding of \p graph with the algorithm of Fakcharoenphol, Rao and Talwar (FRT).
+     * The length of an edge is the maximum edge weight divided by its weight, hence heavy edges
+     * are short. For a random order of the nodes and a random factor beta in [1, 2), the nodes
+     * are clustered on every level i by the first node in the order within distance
+     * beta * 2^(i-1). The clusters of a level refine the clusters of the level above. \n
+     * The nodes 0 to n-1 of the tree are the leaves and correspond to the n nodes of \p graph.
+     * They have the same weights as in \p graph. The other nodes are the clusters and have
+     * weight zero. Clusters with a single child are left out. The edge from a cluster to its
+     * parent has the weight of the edges between the cluster and the rest of the graph.
+     * @param graph The graph.
+     * @param seed The seed for the order and beta (default 0).
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The tree.
+     * @see graph::least_element_lists()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight,
+        typename RandGen=std::mt19937_64>
+            Graph<Id, NodeWeight, EdgeWeight> frt_tree(
+                    Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                    size_t seed=0,
+                    size_t thread_cnt=0) {
+                size_t const node_cnt = static_cast<size_t>(graph.node_cnt());
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const csr_graph = graph.to_weighted_csr_graph(thread_cnt);
+                if (node_cnt <= 1) {
+                    return Graph<Id, NodeWeight, EdgeWeight>(csr_graph, thread_cnt);
+                }
+
+                EdgeWeight max_weight = 1;
+                for (auto const weight : csr_graph.adjwgt) {
+                    max_weight = std::max(max_weight, weight);
+                }
+                std::vector<double> edge_length(csr_graph.adjwgt.size());
+                for (size_t edge_idx = 0; edge_idx < edge_length.size(); ++edge_idx) {
+                    edge_length[edge_idx] = static_cast<double>(max_weight) /
+                        static_cast<double>(std::max(csr_graph.adjwgt[edge_idx], static_cast<EdgeWeight>(1)));
+                }
+
+                RandGen rand_gen(seed);
+                std::vector<Id> order(node_cnt);
+                for (size_t node = 0; node < node_cnt; ++node) {
+                    order[node] = static_cast<Id>(node);
+                }
+                std::shuffle(order.begin(), order.end(), rand_gen);
+                double const beta = std::uniform_real_distribution<double>(1.0, 2.0)(rand_gen);
+                auto const lists = least_element_lists(csr_graph, edge_length, order, thread_cnt);
+
+                // On the top level all nodes of a connected component are in one cluster.
+                double const diameter_bound = static_cast<double>(max_weight) * static_cast<double>(node_cnt);
+                int top_level = 1;
+                while (std::ldexp(1.0, top_level - 1) < diameter_bound) {
+                    top_level += 1;
+                }
 
-                std::vector<Id> roots = union_find.roots();
-                for (Id root_idx = 1; root_idx < roots.size(); ++root_idx) {
-                    rst_graph.edge_weight(roots[0], roots[root_idx], 0);
+                // The root is a cluster of all nodes. Nodes which are alone in their cluster become leaves.
+                std::vector<Id> parent(node_cnt + 1, -1);
+                std::vector<EdgeWeight> parent_weight(node_cnt + 1, 0);
+                std::vector<Id> cluster(node_cnt, static_cast<Id>(node_cnt));
+                std::vector<Id> active(order);
+                std::vector<Id> center(node_cnt);
+                std::vector<EdgeWeight> boundary(node_cnt);
+                for (int level = top_level; level >= 0 && !active.empty(); --level) {
+                    double const radius = beta * std::ldexp(1.0, level - 1);
+                    for (auto const node : active) {
+                        auto const& list = lists[static_cast<size_t>(node)];
+                        center[static_cast<size_t>(node)] = std::find_if(list.cbegin(), list.cend(),
+                                [radius](LeastElement<Id> const& entry){ return entry.distance <= radius; })->center;
+                    }
+                    std::sort(active.begin(), active.end(), [&cluster, &center](Id lhs, Id rhs){
+                            size_t const lhs_st = static_cast<size_t>(lhs);
+                            size_t const rhs_st = static_cast<size_t>(rhs);
+                            return std::tie(cluster[lhs_st], center[lhs_st], lhs) <
+                                std::tie(cluster[rhs_st], center[rhs_st], rhs);
+                            });
+
+                    // Split every cluster which has more than one group of nodes with the same center.
+                    std::vector<Id> new_clusters;
+                    std::vector<Id> next_active;
+                    for (size_t cluster_begin = 0; cluster_begin < active.size();) {
+                        Id const curr_cluster = cluster[static_cast<size_t>(active[cluster_begin])];
+                        size_t cluster_end = cluster_begin;
+                        while (cluster_end < active.size() && cluster[static_cast<size_t>(active[cluster_end])] == curr_cluster) {
+                            ++cluster_end;
+                        }
+                        Id const first_center = center[static_cast<size_t>(active[cluster_begin])];
+                        bool const is_split = center[static_cast<size_t>(active[cluster_end - 1])] != first_center;
+                        for (size_t group_begin = cluster_begin; group_begin < cluster_end;) {
+                            Id const group_center = center[static_cast<size_t>(active[group_begin])];
+                            size_t group_end = group_begin;
+                            while (group_end < cluster_end && center[static_cast<size_t>(active[group_end])] == group_center) {
+                                ++group_end;
+                            }
+                            if (is_split && group_end - group_begin == 1) {
+                                Id const leaf = active[group_begin];
+                                parent[static_cast<size_t>(leaf)] = curr_cluster;
+                                cluster[static_cast<size_t>(leaf)] = leaf;
+                                new_clusters.push_back(leaf);
+                            } else {
+                                Id group_cluster = curr_cluster;
+                                if (is_split) {
+                                    group_cluster = static_cast<Id>(parent.size());
+                                    parent.push_back(curr_cluster);
+                                    parent_weight.push_back(0);
+                                    new_clusters.push_back(group_cluster);
+                                }
+                                for (size_t pos = group_begin; pos < group_end; ++pos) {
+                                    cluster[static_cast<size_t>(active[pos])] = group_cluster;
+                                    next_active.push_back(active[pos]);
+                                }
+                            }
+                            group_begin = group_end;
+                        }
+                        cluster_begin = cluster_end;
+                    }
+
+                    // The weight of the edge to the parent is the weight of the edges leaving the cluster.
+                    parutils::parallel_for(active.size(), thread_cnt, [&](size_t pos){
+                            size_t const node = static_cast<size_t>(active[pos]);
+                            boundary[node] = 0;
+                            for (size_t edge_idx = csr_graph.xadj[node]; edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                                size_t const to_node = static_cast<size_t>(csr_graph.adjncy[edge_idx]);
+                                if (cluster[to_node] != cluster[node]) {
+                                    boundary[node] += csr_graph.adjwgt[edge_idx];
+                                }
+                            }
+                            });
+                    std::vector<bool> is_new(parent.size(), false);
+                    for (auto const new_cluster : new_clusters) {
+                        is_new[static_cast<size_t>(new_cluster)] = true;
+                    }
+                    for (auto const node : active) {
+                        size_t const node_cluster = static_cast<size_t>(cluster[static_cast<size_t>(node)]);
+                        if (is_new[node_cluster]) {
+                            parent_weight[node_cluster] += boundary[static_cast<size_t>(node)];
+                        }
+                    }
+                    active.swap(next_active);
                 }
 
-                return rst_graph;
+                return tree_from_parents<Id, NodeWeight, EdgeWeight>(parent, parent_weight, csr_graph.vwgt, thread_cnt);
+            }
+
+    /**
+     * Partition \p graph with a multilevel scheme which uses the tree partitioning on the
+     * coarsest level.
+     * The graph is coarsened with heavy edge matchings until it has at most \p coarse_node_cnt
+     * nodes. Like in METIS, unmatched nodes with a common neighbor are paired as well and two nodes
+     * are only matched if their combined weight is at most 1.5 times the average weight of a node of
+     * the coarsest graph and less than the weight of a part. Coarsening stops early once a round
+     * shrinks the graph by less than ten percent. The maximum spanning tree of the coarsest graph,
+     * which keeps the heavy edges that are the most expensive ones to cut, is partitioned with the
+     * method of Feldmann and Foschini on node weights scaled to one per node on average and the
+     * balance is repaired for the weights of the graph. If this fails, the next finer level is
+     * tried instead. Afterwards the partition is projected back level by level and refined with
+     * size-constrained label propagation on every level. Since neither the projection nor the
+     * refinement overload a part, the partition obeys \p imbalance.
+     * @param graph The graph to partition.
+     * @param kparts The number of parts to partition into.
+     * @param imbalance The desired maximum imbalance of the partitioning.
+     * @param coarse_node_cnt The number of nodes of the coarsest graph (default 40).
+     * @param seed The seed for the matchings (default 0).
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The partition with its cost on \p graph.
+     *
+     * @throws part::PartitionException if no level can be partitioned.
+     * @see graph::heavy_edge_matching()
+     * @see graph::extend_two_hop_matching()
+     * @see graph::boruvka_spanning_tree()
+     * @see graph::Graph::partition_scaled()
+     * @see graph::rebalance_partition()
+     * @see graph::refine_label_propagation()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight,
+        typename RandGen=std::mt19937_64>
+            PartitionResult<Id, EdgeWeight> partition_multilevel(
+                    Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                    Id kparts,
+                    Rational const& imbalance,
+                    Id coarse_node_cnt=40,
+                    size_t seed=0,
+                    size_t thread_cnt=0) {
+                // The number of label propagation rounds on each level.
+                size_t const refine_round_cnt = 5;
+
+                NodeWeight total_weight = 0;
+                for (Id node = 0; node < graph.node_cnt(); ++node) {
+                    total_weight += graph.node_weight(node);
+                }
+                NodeWeight const max_weight = max_part_weight(total_weight, kparts, imbalance);
+                NodeWeight const max_node_weight = std::max(static_cast<NodeWeight>(1), std::min(
+                            gmputils::ceil_to_int<NodeWeight>(Rational(3, 2) *
+                                Rational(total_weight, std::max(coarse_node_cnt, static_cast<Id>(1)))),
+                            static_cast<NodeWeight>(max_weight - 1)));
+
+                std::vector<WeightedCsrGraph<Id, NodeWeight, EdgeWeight>> levels;
+                std::vector<std::vector<Id>> level_labels;
+                Graph<Id, NodeWeight, EdgeWeight> coarse(graph);
+                while (coarse.node_cnt() > coarse_node_cnt) {
+                    auto matching = heavy_edge_matching<Id, NodeWeight, EdgeWeight, RandGen>(
+                            coarse, seed + levels.size(), max_node_weight);
+                    extend_two_hop_matching(coarse, matching, max_node_weight);
+                    if (static_cast<Id>(matching.size()) * 10 < coarse.node_cnt()) {
+                        break;
+                    }
+                    if (coarse.node_cnt() - static_cast<Id>(matching.size()) < coarse_node_cnt) {
+                        matching.resize(static_cast<size_t>(coarse.node_cnt() - coarse_node_cnt));
+                    }
+
+                    std::vector<Id> partner(static_cast<size_t>(coarse.node_cnt()), -1);
+                    for (auto const& edge : matching) {
+                        partner[static_cast<size_t>(edge.first)] = edge.second;
+                        partner[static_cast<size_t>(edge.second)] = edge.first;
+                    }
+                    std::vector<Id> labels(static_cast<size_t>(coarse.node_cnt()), -1);
+                    Id label_cnt = 0;
+                    for (size_t node = 0; node < labels.size(); ++node) {
+                        if (labels[node] < 0) {
+                            labels[node] = label_cnt;
+                            if (partner[node] >= 0) {
+                                labels[static_cast<size_t>(partner[node])] = label_cnt;
+                            }
+                            label_cnt += 1;
+                        }
+                    }
+
+                    levels.push_back(coarse.to_weighted_csr_graph(thread_cnt));
+                    coarse.contract_nodes(labels, label_cnt);
+                    level_labels.push_back(std::move(labels));
+                }
+                levels.push_back(coarse.to_weighted_csr_graph(thread_cnt));
+
+                // Partition the coarsest level which can be partitioned. The node weights of the tree are
+                // scaled to one per node on average, otherwise the cut takes time and memory in the order
+                // of the weight of the graph. The rounding error is repaired on the level itself.
+                auto const partition_level = [kparts, &imbalance, thread_cnt](
+                        Graph<Id, NodeWeight, EdgeWeight> const& level_graph) {
+                    auto const tree = boruvka_spanning_tree(level_graph,
+                            [](Id, Id, EdgeWeight edge_weight){ return -edge_weight; }, thread_cnt);
+                    auto result = tree.partition_scaled(kparts, imbalance, static_cast<NodeWeight>(
+                                std::max(level_graph.node_cnt(), kparts)));
+                    rebalance_partition(level_graph, result, kparts, imbalance, thread_cnt);
+                    if (level_graph.partition_imbalance(result.second, kparts) > imbalance) {
+                        throw part::PartitionException();
+                    }
+                    return result.second;
+                };
+                std::vector<Id> partition;
+                size_t level = levels.size() - 1;
+                for (;; --level) {
+                    try {
+                        partition = (level + 1 == levels.size()) ? partition_level(coarse) :
+                            partition_level(Graph<Id, NodeWeight, EdgeWeight>(levels[level], thread_cnt));
+                        break;
+                    } catch (part::PartitionException const&) {
+                        if (level == 0) {
+                            throw;
+                        }
+                    }
+                }
+                refine_label_propagation(levels[level], partition, kparts, max_weight, refine_round_cnt, thread_cnt);
+
+                while (level-- > 0) {
+                    std::vector<Id> const& labels = level_labels[level];
+                    std::vector<Id> fine_partition(labels.size());
+                    for (size_t node = 0; node < labels.size(); ++node) {
+                        fine_partition[node] = partition[static_cast<size_t>(labels[node])];
+                    }
+                    partition.swap(fine_partition);
+                    refine_label_propagation(levels[level], partition, kparts, max_weight, refine_round_cnt, thread_cnt);
+                }
+
+                return std::make_pair(cut_cost(levels.front(), partition, thread_cnt), partition);
+            }
+
+    /**
+     * Statistics for a single spanning tree of an ensemble.
+     * @see graph::partition_rst_ensemble()
+     */
+    template<typename EdgeWeight>
+        struct EnsembleTreeStats {
+            size_t rst_seed; /**< The seed which was used to generate the RST. */
+            bool is_feasible; /**< False if the tree could not be partitioned. */
+            EdgeWeight tree_cut_cost; /**< The cost of the partition on the RST. */
+            EdgeWeight graph_cut_cost; /**< The cost of the partition on the original graph. */
+            std::chrono::milliseconds time_elapsed; /**< The time to generate and partition the RST. */
+        };
+
+    /**
+     * The result of partitioning with an ensemble of spanning trees.
+     * @see graph::partition_rst_ensemble()
+     */
+    template<typename Id, typename EdgeWeight>
+        struct EnsembleResult {
+            PartitionResult<Id, EdgeWeight> best; /**< The best partition with its cost on the graph. */
+            size_t best_tree_idx; /**< The index of the tree which yielded the best partition. */
+            std::vector<EnsembleTreeStats<EdgeWeight>> tree_stats; /**< Statistics for each tree. */
+        };
+
+    /**
+     * Partition a graph by partitioning an ensemble of random spanning trees.
+     * The RSTs are generated and partitioned concurrently. The partition of each tree is scored
+     * on \p graph and the partition with the lowest cost on \p graph is returned. Ties are
+     * broken in favor of the tree with the lower index, hence the result does not depend on the
+     * number of threads.
+     * @param graph The graph to partition.
+     * @param kparts The number of parts to partition into.
+     * @param imbalance The desired maximum imbalance of the partitioning.
+     * @param tree_cnt The number of RSTs in the ensemble.
+     * @param seed The seed for the first RST, the i-th RST uses \p seed + i (default 0).
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The best partition and the statistics for each tree.
+     *
+     * @throws part::PartitionException if none of the trees can be partitioned.
+     * @see graph::rst()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight,
+        typename RandGen=std::mt19937_64>
+            EnsembleResult<Id, EdgeWeight> partition_rst_ensemble(
+                    Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                    Id kparts,
+                    Rational const& imbalance,
+                    size_t tree_cnt,
+                    size_t seed=0,
+                    size_t thread_cnt=0) {
+
+                EnsembleResult<Id, EdgeWeight> result;
+                result.tree_stats.resize(tree_cnt);
+                std::vector<PartitionResult<Id, EdgeWeight>> tree_results(tree_cnt);
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const csr_graph = graph.to_weighted_csr_graph(thread_cnt);
+
+                parutils::parallel_for_dynamic(tree_cnt, thread_cnt,
+                        [&graph, &csr_graph, kparts, &imbalance, seed, &result, &tree_results](size_t tree_idx){
+                        using namespace std::chrono;
+                        auto const start = steady_clock::now();
+                        EnsembleTreeStats<EdgeWeight>& stats = result.tree_stats[tree_idx];
+                        stats.rst_seed = seed + tree_idx;
+                        stats.is_feasible = true;
+
+                        // The trees are already processed in parallel, so the RST is built serially.
+                        auto const tree = rst<Id, NodeWeight, EdgeWeight, RandGen>(graph, stats.rst_seed, 1);
+                        try {
+                            tree_results[tree_idx] = tree.partition(kparts, Rational(imbalance));
+                            stats.tree_cut_cost = tree_results[tree_idx].first;
+                            stats.graph_cut_cost = cut_cost(csr_graph, tree_results[tree_idx].second, 1);
+                            tree_results[tree_idx].first = stats.graph_cut_cost;
+                        } catch (part::PartitionException const&) {
+                            stats.is_feasible = false;
+                            stats.tree_cut_cost = 0;
+                            stats.graph_cut_cost = 0;
+                        }
+                        stats.time_elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+                        });
+
+                bool has_feasible = false;
+                for (size_t tree_idx = 0; tree_idx < tree_cnt; ++tree_idx) {
+                    auto const& stats = result.tree_stats[tree_idx];
+                    if (stats.is_feasible &&
+                            (!has_feasible || stats.graph_cut_cost < result.best.first)) {
+                        result.best = tree_results[tree_idx];
+                        result.best_tree_idx = tree_idx;
+                        has_feasible = true;
+                    }
+                }
+
+                if (!has_feasible) {
+                    throw part::PartitionException();
+                }
+                return result;
             }
 }
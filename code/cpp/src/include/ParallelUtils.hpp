@@ -0,0 +1,139 @@
+/** @file ParallelUtils.hpp */
+#pragma once
+
+#include<algorithm>
+#include<atomic>
+#include<cstddef>
+#include<future>
+#include<thread>
+#include<vector>
+
+/**
+ * Contains utilities to distribute work over multiple threads.
+ * Everything in here only uses the C++11 thread support library.
+ */
+namespace parutils {
+
+    /**
+     * The minimum number of items a thread should process.
+     * Ranges smaller than this are processed on the calling thread.
+     */
+    static size_t const MIN_BLOCK_SIZE = 1024;
+
+    /**
+     * Determine the number of threads to use.
+     * @param thread_cnt The requested number of threads. Zero means that the number
+     *  of hardware threads is used.
+     * @returns The number of threads to use which is always at least one.
+     */
+    inline size_t get_thread_cnt(size_t thread_cnt=0) {
+        if (thread_cnt == 0) {
+            thread_cnt = static_cast<size_t>(std::thread::hardware_concurrency());
+        }
+        return std::max(thread_cnt, static_cast<size_t>(1));
+    }
+
+    /**
+     * Split the range [0, \p size) into contiguous blocks and process each block on
+     * its own thread. The last block is processed on the calling thread.
+     * Exceptions thrown by \p body are rethrown on the calling thread.
+     * @param size The size of the range.
+     * @param thread_cnt The maximum number of threads to use (0 for the number of hardware threads).
+     * @param body A function taking the begin and end of a block and the index of the block.
+     * @returns The number of blocks that were used.
+     */
+    template<typename Body>
+        size_t parallel_for_blocks(size_t size, size_t thread_cnt, Body body) {
+            size_t block_cnt = std::min(get_thread_cnt(thread_cnt),
+                    std::max(size / MIN_BLOCK_SIZE, static_cast<size_t>(1)));
+            size_t const block_size = (size + block_cnt - 1) / std::max(block_cnt, static_cast<size_t>(1));
+
+            std::vector<std::future<void>> futures;
+            for (size_t block_idx = 0; block_idx + 1 < block_cnt; ++block_idx) {
+                size_t const begin = std::min(block_idx * block_size, size);
+                size_t const end = std::min(begin + block_size, size);
+                futures.push_back(std::async(std::launch::async, [&body, begin, end, block_idx](){
+                            body(begin, end, block_idx);
+                            }));
+            }
+            body(std::min((block_cnt - 1) * block_size, size), size, block_cnt - 1);
+            for (auto& future : futures) {
+                future.get();
+            }
+            return block_cnt;
+        }
+
+    /**
+     * Call \p body for every index in [0, \p size) using multiple threads.
+     * @param size The size of the range.
+     * @param thread_cnt The maximum number of threads to use (0 for the number of hardware threads).
+     * @param body A function taking an index.
+     */
+    template<typename Body>
+        void parallel_for(size_t size, size_t thread_cnt, Body body) {
+            parallel_for_blocks(size, thread_cnt, [&body](size_t begin, size_t end, size_t){
+                    for (size_t idx = begin; idx < end; ++idx) {
+                        body(idx);
+                    }
+                    });
+        }
+
+    /**
+     * Call \p body for every index in [0, \p size) using multiple threads.
+     * In contrast to parallel_for() the indices are handed out one by one, which balances
+     * the load if the work per index is large and varies a lot.
+     * Exceptions thrown by \p body are rethrown on the calling thread.
+     * @param size The size of the range.
+     * @param thread_cnt The maximum number of threads to use (0 for the number of hardware threads).
+     * @param body A function taking an index.
+     */
+    template<typename Body>
+        void parallel_for_dynamic(size_t size, size_t thread_cnt, Body body) {
+            size_t const worker_cnt = std::min(get_thread_cnt(thread_cnt), std::max(size, static_cast<size_t>(1)));
+            std::atomic<size_t> next_idx(0);
+            auto worker = [&body, &next_idx, size](){
+                for (size_t idx = next_idx++; idx < size; idx = next_idx++) {
+                    body(idx);
+                }
+            };
+
+            std::vector<std::future<void>> futures;
+            for (size_t worker_idx = 0; worker_idx + 1 < worker_cnt; ++worker_idx) {
+                futures.push_back(std::async(std::launch::async, worker));
+            }
+            worker();
+            for (auto& future : futures) {
+                future.get();
+            }
+        }
+
+    /**
+     * Reduce the range [0, \p size) in parallel.
+     * Each thread folds its block with \p map and \p reduce starting from \p init, afterwards the
+     * results of the blocks are combined in order with \p reduce.
+     * @param size The size of the range.
+     * @param thread_cnt The maximum number of threads to use (0 for the number of hardware threads).
+     * @param init The neutral element of \p reduce.
+     * @param map A function mapping an index to a value.
+     * @param reduce An associative function combining two values.
+     * @returns The reduced value.
+     */
+    template<typename T, typename Map, typename Reduce>
+        T parallel_reduce(size_t size, size_t thread_cnt, T init, Map map, Reduce reduce) {
+            std::vector<T> block_results(get_thread_cnt(thread_cnt), init);
+            size_t const block_cnt = parallel_for_blocks(size, thread_cnt,
+                    [&block_results, &map, &reduce](size_t begin, size_t end, size_t block_idx){
+                    T block_result = block_results[block_idx];
+                    for (size_t idx = begin; idx < end; ++idx) {
+                        block_result = reduce(block_result, map(idx));
+                    }
+                    block_results[block_idx] = block_result;
+                    });
+
+            T result = init;
+            for (size_t block_idx = 0; block_idx < block_cnt; ++block_idx) {
+                result = reduce(result, block_results[block_idx]);
+            }
+            return result;
+        }
+}
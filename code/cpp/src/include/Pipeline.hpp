@@ -0,0 +1,339 @@
+/**
+ * @file Pipeline.hpp
+ * This file contains a pipeline which partitions a graph given as SNAP edge list by contracting
+ * it, building a decomposition tree of it and partitioning the tree. All stages run in memory
+ * of a single process.
+ * @see pipeline::Pipeline
+ */
+#pragma once
+
+#include<algorithm>
+#include<chrono>
+#include<cstdint>
+#include<cstdio>
+#include<fstream>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<stdexcept>
+#include<string>
+#include<utility>
+#include<vector>
+
+#include "FileUtils.hpp"
+#include "Graph.hpp"
+#include "GraphIo.hpp"
+#include "GraphUtils.hpp"
+#include "SnapConvert.hpp"
+
+/**
+ * Contains the in-process pipeline from an edge list to an evaluated partition.
+ */
+namespace pipeline {
+
+    /**
+     * The interface of a decomposition as an abstract class.
+     * A decomposition maps a graph to a tree whose nodes 0 to n-1 are the n nodes of the graph
+     * and carry their weights. All other nodes of the tree have weight zero.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct IDecomposer {
+            public:
+                /**
+                 * Virtual deconstructor to prevent memory leaks.
+                 */
+                virtual ~IDecomposer() {}
+
+                /**
+                 * Build the decomposition tree of \p graph.
+                 * @param graph The graph.
+                 * @returns The decomposition tree.
+                 */
+                virtual graph::Graph<Id, NodeWeight, EdgeWeight> operator()(
+                        graph::Graph<Id, NodeWeight, EdgeWeight> const& graph) const=0;
+        };
+
+    /**
+     * Build a decomposition tree by recursive bisection in this process.
+     * @see graph::decomposition_tree()
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct BisectionDecomposer : public IDecomposer<Id, NodeWeight, EdgeWeight> {
+            public:
+                graph::Rational imbalance; /**< The maximum imbalance of each bisection. */
+                size_t thread_cnt; /**< The number of threads to use. */
+
+                /**
+                 * Constructor.
+                 * @param imbalance The maximum imbalance of each bisection (default 1/10).
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+                 */
+                BisectionDecomposer(graph::Rational imbalance=graph::Rational(1, 10), size_t thread_cnt=0) :
+                    imbalance(imbalance), thread_cnt(thread_cnt) {}
+
+                graph::Graph<Id, NodeWeight, EdgeWeight> operator()(
+                        graph::Graph<Id, NodeWeight, EdgeWeight> const& graph) const override {
+                    return graph::decomposition_tree(graph, this->imbalance, this->thread_cnt);
+                }
+        };
+
+    /**
+     * Quote \p str for the use as a single argument of a shell command.
+     * @param str The string.
+     * @returns The quoted string.
+     */
+    inline std::string shell_quote(std::string const& str) {
+        std::string quoted("'");
+        for (char c : str) {
+            if (c == '\'') {
+                quoted += "'\\''";
+            } else {
+                quoted.push_back(c);
+            }
+        }
+        quoted.push_back('\'');
+        return quoted;
+    }
+
+    /**
+     * Build a hierarchical decomposition with the jar in \p deps/hierarchical-decomposition.
+     * The graph is handed to the jar in a temporary file and the output of the jar is parsed
+     * directly from the pipe. The infinite edges of the output are contracted.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct JarDecomposer : public IDecomposer<Id, NodeWeight, EdgeWeight> {
+            public:
+                std::string jar; /**< The path of the jar. */
+                std::string jar_args; /**< Additional arguments for the jar. */
+                std::string tmp_dir; /**< The directory for temporary files and the log of the jar. */
+                size_t thread_cnt; /**< The number of threads to parse the output with. */
+
+                /**
+                 * Constructor.
+                 * @param jar The path of the jar.
+                 * @param jar_args Additional arguments for the jar which are passed unquoted.
+                 * @param tmp_dir The directory for temporary files. Default: /tmp.
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+                 */
+                JarDecomposer(std::string jar, std::string jar_args="", std::string tmp_dir="/tmp",
+                        size_t thread_cnt=0) :
+                    jar(jar), jar_args(jar_args), tmp_dir(tmp_dir), thread_cnt(thread_cnt) {}
+
+                /**
+                 * @copydoc IDecomposer::operator()()
+                 *
+                 * @throws std::runtime_error if the jar can not be started or fails.
+                 */
+                graph::Graph<Id, NodeWeight, EdgeWeight> operator()(
+                        graph::Graph<Id, NodeWeight, EdgeWeight> const& graph) const override {
+                    fileutils::NamedTempFile input(this->tmp_dir);
+                    {
+                        std::ofstream input_stream(input.path());
+                        input_stream << graph;
+                        if (!input_stream) {
+                            throw std::runtime_error("Writing the input of the decomposition failed.");
+                        }
+                    }
+
+                    std::string const command = "cd " + shell_quote(this->tmp_dir) +
+                        " && java -jar " + shell_quote(this->jar) + " " + this->jar_args +
+                        " < " + shell_quote(input.path());
+                    std::FILE* pipe = ::popen(command.c_str(), "r");
+                    if (pipe == nullptr) {
+                        throw std::runtime_error("Starting the decomposition failed: " + command);
+                    }
+                    std::string output;
+                    std::vector<char> buffer(static_cast<size_t>(1) << 20);
+                    for (size_t read_cnt = std::fread(buffer.data(), 1, buffer.size(), pipe); read_cnt > 0;
+                            read_cnt = std::fread(buffer.data(), 1, buffer.size(), pipe)) {
+                        output.append(buffer.data(), read_cnt);
+                    }
+                    if (::pclose(pipe) != 0) {
+                        throw std::runtime_error("The decomposition failed: " + command);
+                    }
+
+                    graph::Graph<Id, NodeWeight, EdgeWeight> tree;
+                    graphio::parse_graph(output.data(), output.data() + output.size(), tree, this->thread_cnt);
+                    graph::contract_inf_edges(tree, std::numeric_limits<EdgeWeight>::max());
+                    return tree;
+                }
+        };
+
+    /**
+     * The time one stage of the pipeline took.
+     */
+    struct StageTiming {
+        std::string stage; /**< The name of the stage. */
+        std::chrono::milliseconds time_elapsed; /**< The time the stage took. */
+    };
+
+    /**
+     * Options for Pipeline.
+     * Intermediate graphs are only written if a file name is given.
+     */
+    template<typename Id=int32_t>
+        struct PipelineOptions {
+            Id kparts; /**< The number of parts. */
+            graph::Rational imbalance; /**< The maximum imbalance of the partition. */
+            Id contract_to; /**< The number of nodes to contract to (0 to skip the contraction). */
+            bool has_header; /**< Indicates whether the edge list starts with a header. */
+            size_t seed; /**< The seed for the contraction. */
+            size_t thread_cnt; /**< The number of threads to use (0 for all hardware threads). */
+            std::string graph_file; /**< The file for the input graph in the METIS format. */
+            std::string contracted_file; /**< The file for the contracted graph in the METIS format. */
+            std::string decomposed_file; /**< The file for the decomposition tree in the METIS format. */
+
+            /**
+             * Constructor.
+             * @param kparts The number of parts.
+             * @param imbalance The maximum imbalance of the partition.
+             * @param contract_to The number of nodes to contract to (default 0 to skip the contraction).
+             */
+            PipelineOptions(Id kparts, graph::Rational imbalance, Id contract_to=0) :
+                kparts(kparts), imbalance(imbalance), contract_to(contract_to), has_header(true),
+                seed(0), thread_cnt(0) {}
+        };
+
+    /**
+     * The result of a run of the pipeline.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct PipelineResult {
+            std::vector<Id> partition; /**< The part of each node of the input graph. */
+            EdgeWeight tree_cut_cost; /**< The cost of the partition on the decomposition tree. */
+            EdgeWeight cut_cost; /**< The cost of the partition on the input graph. */
+            NodeWeight max_part_weight; /**< The weight of the heaviest part. */
+            NodeWeight total_weight; /**< The weight of all nodes. */
+            Id node_cnt; /**< The number of nodes of the input graph. */
+            Id contracted_node_cnt; /**< The number of nodes of the contracted graph. */
+            Id decomposed_node_cnt; /**< The number of nodes of the decomposition tree. */
+            std::vector<StageTiming> timings; /**< The timings of the stages in the order they ran. */
+        };
+
+    /**
+     * Partition a graph given as SNAP edge list in a single process.
+     * The stages are: read, contract, decompose, partition, map back and evaluate. Each stage
+     * takes the graph of the previous stage and the graphs are only kept as long as later stages
+     * need them. The time of each stage is recorded.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        struct Pipeline {
+            public:
+                using Graph = graph::Graph<Id, NodeWeight, EdgeWeight>;
+                using Result = PipelineResult<Id, NodeWeight, EdgeWeight>;
+
+                PipelineOptions<Id> options; /**< The options. */
+                std::shared_ptr<IDecomposer<Id, NodeWeight, EdgeWeight>> decomposer; /**< The decomposition. */
+
+                /**
+                 * Constructor.
+                 * @param options The options.
+                 * @param decomposer The decomposition to use.
+                 */
+                Pipeline(PipelineOptions<Id> options,
+                        std::shared_ptr<IDecomposer<Id, NodeWeight, EdgeWeight>> const& decomposer) :
+                    options(options), decomposer(decomposer) {}
+
+            private:
+                /**
+                 * Run \p stage and record its time in \p timings.
+                 * @param timings The timings.
+                 * @param name The name of the stage.
+                 * @param stage A function without arguments.
+                 * @returns The result of \p stage.
+                 */
+                template<typename Stage>
+                    static auto timed(std::vector<StageTiming>& timings, std::string const& name, Stage stage)
+                    -> decltype(stage()) {
+                        using namespace std::chrono;
+                        auto const start = steady_clock::now();
+                        auto result = stage();
+                        timings.push_back(StageTiming{name, duration_cast<milliseconds>(steady_clock::now() - start)});
+                        return result;
+                    }
+
+                /**
+                 * Write \p graph in the METIS format to \p filename if the name is not empty.
+                 * @param graph The graph.
+                 * @param filename The name of the file.
+                 *
+                 * @throws std::runtime_error if the file can not be written.
+                 */
+                static void write_if_requested(Graph const& graph, std::string const& filename) {
+                    if (filename.empty()) {
+                        return;
+                    }
+                    std::ofstream file(filename);
+                    file << graph;
+                    if (!file) {
+                        throw std::runtime_error("Writing " + filename + " failed.");
+                    }
+                }
+
+            public:
+                /**
+                 * Run the pipeline on the edge list in \p is.
+                 * @param is The input stream with the edge list in the SNAP format.
+                 * @returns The partition of the input graph and its evaluation.
+                 *
+                 * @throws part::PartitionException if the decomposition tree can not be partitioned.
+                 * @see graphio::read_snap_graph()
+                 */
+                Result operator()(std::istream& is) const {
+                    PipelineOptions<Id> const& opts = this->options;
+                    Result result;
+
+                    Graph const graph = timed(result.timings, "read", [&is, &opts](){
+                            return graphio::read_snap_graph<Id, NodeWeight, EdgeWeight>(
+                                    is, opts.has_header, opts.thread_cnt);
+                            });
+                    write_if_requested(graph, opts.graph_file);
+                    result.node_cnt = graph.node_cnt();
+
+                    Graph contracted = timed(result.timings, "contract", [&graph, &opts]() -> Graph {
+                            if (opts.contract_to <= 0 || opts.contract_to >= graph.node_cnt()) {
+                                return Graph(graph);
+                            }
+                            return graph::contract_to_n_nodes(graph, opts.contract_to, opts.seed);
+                            });
+                    write_if_requested(contracted, opts.contracted_file);
+                    result.contracted_node_cnt = contracted.node_cnt();
+
+                    IDecomposer<Id, NodeWeight, EdgeWeight> const& decompose = *this->decomposer;
+                    Graph decomposed = timed(result.timings, "decompose", [&contracted, &decompose](){
+                            return decompose(contracted);
+                            });
+                    write_if_requested(decomposed, opts.decomposed_file);
+                    result.decomposed_node_cnt = decomposed.node_cnt();
+
+                    auto tree_part = timed(result.timings, "partition", [&decomposed, &opts](){
+                            return decomposed.partition(opts.kparts, opts.imbalance);
+                            });
+                    result.tree_cut_cost = tree_part.first;
+
+                    result.partition = timed(result.timings, "map back", [&]() -> std::vector<Id> {
+                            // The first nodes of the decomposition are the nodes of the contracted graph.
+                            std::vector<Id> contracted_part = decomposed.convert_part_to_node_repr(tree_part.second);
+                            contracted_part.resize(static_cast<size_t>(contracted.node_cnt()));
+                            decomposed = Graph();
+                            std::vector<Id> part = contracted.convert_part_to_node_repr(contracted_part);
+                            contracted = Graph();
+                            return part;
+                            });
+
+                    timed(result.timings, "evaluate", [&graph, &opts, &result]() -> EdgeWeight {
+                            std::vector<NodeWeight> part_weights(static_cast<size_t>(opts.kparts), 0);
+                            result.total_weight = 0;
+                            for (Id node = 0; node < graph.node_cnt(); ++node) {
+                                part_weights.at(static_cast<size_t>(result.partition.at(node))) += graph.node_weight(node);
+                                result.total_weight += graph.node_weight(node);
+                            }
+                            result.max_part_weight = *std::max_element(part_weights.cbegin(), part_weights.cend());
+                            result.cut_cost = graph.partition_cost(result.partition, opts.thread_cnt);
+                            return result.cut_cost;
+                            });
+
+                    return result;
+                }
+        };
+}
@@ -0,0 +1,565 @@
+/**
+ * @file Refine.hpp
+ * This file contains local refinement of partitions which keeps their balance.
+ */
+#pragma once
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<queue>
+#include<string>
+#include<utility>
+#include<vector>
+
+#include "GMPUtils.hpp"
+#include "Graph.hpp"
+#include "ParallelUtils.hpp"
+
+namespace graph {
+
+    /**
+     * Statistics of one pass of the refinement.
+     * @see graph::refine_partition()
+     */
+    template<typename EdgeWeight>
+        struct RefineRound {
+            std::string pass; /**< The name of the refinement pass. */
+            EdgeWeight cut_before; /**< The cut before the pass. */
+            EdgeWeight cut_after; /**< The cut after the pass. */
+            size_t move_cnt; /**< The number of moves which were kept. */
+            std::chrono::milliseconds time_elapsed; /**< The time the pass took. */
+        };
+
+    /**
+     * Calculate the accumulated weight of the edges cut by \p partition.
+     * The nodes are processed in parallel.
+     * @param csr_graph The graph.
+     * @param partition The part of each node.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The weight of the cut.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        EdgeWeight cut_cost(WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph,
+                std::vector<Id> const& partition, size_t thread_cnt=0) {
+            return parutils::parallel_reduce(csr_graph.vwgt.size(), thread_cnt, static_cast<EdgeWeight>(0),
+                    [&csr_graph, &partition](size_t node) -> EdgeWeight {
+                    EdgeWeight node_cost = 0;
+                    for (size_t edge_idx = csr_graph.xadj[node]; edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                        size_t const to_node = static_cast<size_t>(csr_graph.adjncy[edge_idx]);
+                        if (to_node > node && partition[node] != partition[to_node]) {
+                            node_cost += csr_graph.adjwgt[edge_idx];
+                        }
+                    }
+                    return node_cost;
+                    },
+                    [](EdgeWeight lhs, EdgeWeight rhs){ return lhs + rhs; });
+        }
+
+    /**
+     * Maintains the cut and the part weights of a partition while nodes are moved.
+     * Moving a node or asking for the change of the cut a move would cause takes time linear
+     * in the degree of the node.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        struct PartitionEvaluator {
+            private:
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& graph; /**< The graph. */
+                std::vector<Id> node_parts; /**< The part of each node. */
+                std::vector<NodeWeight> part_weights; /**< The weight of each part. */
+                EdgeWeight cut; /**< The weight of the cut edges. */
+
+            public:
+                /**
+                 * Constructor.
+                 * @param csr_graph The graph. It must outlive the evaluator.
+                 * @param partition The part of each node.
+                 * @param kparts The number of parts.
+                 * @param thread_cnt The number of threads to use for the initial cut
+                 *  (default 0 for all hardware threads).
+                 */
+                PartitionEvaluator(WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph,
+                        std::vector<Id> partition, Id kparts, size_t thread_cnt=0) :
+                    graph(csr_graph), part_weights(static_cast<size_t>(kparts)) {
+                        this->assign(std::move(partition), thread_cnt);
+                    }
+
+                /**
+                 * Replace the partition and recalculate the cut and the part weights.
+                 * @param partition The part of each node.
+                 * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+                 */
+                void assign(std::vector<Id> partition, size_t thread_cnt=0) {
+                    this->node_parts = std::move(partition);
+                    std::fill(this->part_weights.begin(), this->part_weights.end(), 0);
+                    for (size_t node = 0; node < this->node_parts.size(); ++node) {
+                        this->part_weights[static_cast<size_t>(this->node_parts[node])] += this->graph.vwgt[node];
+                    }
+                    this->cut = graph::cut_cost(this->graph, this->node_parts, thread_cnt);
+                }
+
+                /**
+                 * Getter for the graph.
+                 * @returns The graph.
+                 */
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph() const {
+                    return this->graph;
+                }
+
+                /**
+                 * Getter for the partition.
+                 * @returns The part of each node.
+                 */
+                std::vector<Id> const& partition() const {
+                    return this->node_parts;
+                }
+
+                /**
+                 * Getter for the part of a node.
+                 * @param node The node.
+                 * @returns The part of \p node.
+                 */
+                Id part(Id node) const {
+                    return this->node_parts[static_cast<size_t>(node)];
+                }
+
+                /**
+                 * Getter for the number of parts.
+                 * @returns The number of parts.
+                 */
+                Id part_cnt() const {
+                    return static_cast<Id>(this->part_weights.size());
+                }
+
+                /**
+                 * Getter for the weight of a part.
+                 * @param part The part.
+                 * @returns The accumulated weight of the nodes in \p part.
+                 */
+                NodeWeight part_weight(Id part) const {
+                    return this->part_weights[static_cast<size_t>(part)];
+                }
+
+                /**
+                 * Getter for the cut.
+                 * @returns The accumulated weight of the cut edges.
+                 */
+                EdgeWeight cut_cost() const {
+                    return this->cut;
+                }
+
+                /**
+                 * Calculate how the cut changes if \p node is moved to \p target.
+                 * @param node The node.
+                 * @param target The part to move to.
+                 * @returns The change of the cut, which is negative if the cut gets smaller.
+                 */
+                EdgeWeight move_delta(Id node, Id target) const {
+                    size_t const node_st = static_cast<size_t>(node);
+                    Id const own_part = this->node_parts[node_st];
+                    EdgeWeight delta = 0;
+                    for (size_t edge_idx = this->graph.xadj[node_st]; edge_idx < this->graph.xadj[node_st + 1]; ++edge_idx) {
+                        size_t const to_node = static_cast<size_t>(this->graph.adjncy[edge_idx]);
+                        if (to_node == node_st) {
+                            continue;
+                        }
+                        Id const to_part = this->node_parts[to_node];
+                        if (to_part == own_part) {
+                            delta += this->graph.adjwgt[edge_idx];
+                        } else if (to_part == target) {
+                            delta -= this->graph.adjwgt[edge_idx];
+                        }
+                    }
+                    return (own_part == target) ? 0 : delta;
+                }
+
+                /**
+                 * Move \p node to \p target and update the cut and the part weights.
+                 * @param node The node.
+                 * @param target The part to move to.
+                 * @returns The change of the cut.
+                 */
+                EdgeWeight move(Id node, Id target) {
+                    size_t const node_st = static_cast<size_t>(node);
+                    EdgeWeight const delta = this->move_delta(node, target);
+                    this->part_weights[static_cast<size_t>(this->node_parts[node_st])] -= this->graph.vwgt[node_st];
+                    this->part_weights[static_cast<size_t>(target)] += this->graph.vwgt[node_st];
+                    this->node_parts[node_st] = target;
+                    this->cut += delta;
+                    return delta;
+                }
+        };
+
+    /**
+     * Calculate the maximum weight of a part which is allowed by \p imbalance.
+     * This is the same bound the tree partitioning uses: floor((1+imbalance)*ceil(total_weight/kparts)).
+     * @param total_weight The weight of all nodes.
+     * @param kparts The number of parts.
+     * @param imbalance The maximum imbalance.
+     * @returns The maximum weight of a part.
+     */
+    template<typename NodeWeight, typename Id>
+        NodeWeight max_part_weight(NodeWeight total_weight, Id kparts, Rational const& imbalance) {
+            Rational const weight_per_part(gmputils::ceil_to_int<NodeWeight>(Rational(total_weight, kparts)));
+            return gmputils::floor_to_int<NodeWeight>((Rational(1) + imbalance) * weight_per_part);
+        }
+
+    /**
+     * Refine \p partition with size-constrained label propagation.
+     * In every round each node moves to the part it is connected to most strongly if this
+     * reduces the cut and the part stays within \p max_weight. The nodes are processed in
+     * parallel and moves take effect immediately, hence the parts are always within their
+     * bound. The refinement stops after \p round_cnt rounds or if a round did not move a node.
+     * @param csr_graph The graph.
+     * @param partition The part of each node. This is changed.
+     * @param kparts The number of parts.
+     * @param max_weight The maximum weight of a part.
+     * @param round_cnt The maximum number of rounds.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The number of moved nodes.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        size_t refine_label_propagation(
+                WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph,
+                std::vector<Id>& partition,
+                Id kparts,
+                NodeWeight max_weight,
+                size_t round_cnt,
+                size_t thread_cnt=0) {
+            size_t const node_cnt = csr_graph.vwgt.size();
+            std::vector<std::atomic<Id>> node_part(node_cnt);
+            std::vector<std::atomic<NodeWeight>> part_weight(static_cast<size_t>(kparts));
+            for (auto& weight : part_weight) {
+                weight.store(0, std::memory_order_relaxed);
+            }
+            for (size_t node = 0; node < node_cnt; ++node) {
+                node_part[node].store(partition[node], std::memory_order_relaxed);
+                part_weight[static_cast<size_t>(partition[node])].fetch_add(csr_graph.vwgt[node]);
+            }
+
+            size_t total_move_cnt = 0;
+            for (size_t round = 0; round < round_cnt; ++round) {
+                std::atomic<size_t> move_cnt(0);
+                parutils::parallel_for_blocks(node_cnt, thread_cnt, [&](size_t begin, size_t end, size_t){
+                        std::vector<EdgeWeight> connection(static_cast<size_t>(kparts), 0);
+                        std::vector<Id> touched_parts;
+                        for (size_t node = begin; node < end; ++node) {
+                            Id const own_part = node_part[node].load(std::memory_order_relaxed);
+                            for (size_t edge_idx = csr_graph.xadj[node]; edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                                size_t const to_node = static_cast<size_t>(csr_graph.adjncy[edge_idx]);
+                                if (to_node == node) {
+                                    continue;
+                                }
+                                Id const to_part = node_part[to_node].load(std::memory_order_relaxed);
+                                if (connection[static_cast<size_t>(to_part)] == 0) {
+                                    touched_parts.push_back(to_part);
+                                }
+                                connection[static_cast<size_t>(to_part)] += csr_graph.adjwgt[edge_idx];
+                            }
+
+                            NodeWeight const node_weight = csr_graph.vwgt[node];
+                            Id best_part = own_part;
+                            EdgeWeight best_connection = connection[static_cast<size_t>(own_part)];
+                            for (auto const part : touched_parts) {
+                                EdgeWeight const part_connection = connection[static_cast<size_t>(part)];
+                                if (part_connection > best_connection &&
+                                        part_weight[static_cast<size_t>(part)].load(std::memory_order_relaxed) +
+                                        node_weight <= max_weight) {
+                                    best_part = part;
+                                    best_connection = part_connection;
+                                }
+                            }
+                            for (auto const part : touched_parts) {
+                                connection[static_cast<size_t>(part)] = 0;
+                            }
+                            touched_parts.clear();
+
+                            if (best_part == own_part) {
+                                continue;
+                            }
+                            // Reserve the weight in the target part, another thread may have filled it.
+                            auto& target_weight = part_weight[static_cast<size_t>(best_part)];
+                            NodeWeight curr_weight = target_weight.load(std::memory_order_relaxed);
+                            while (curr_weight + node_weight <= max_weight &&
+                                    !target_weight.compare_exchange_weak(curr_weight, curr_weight + node_weight)) {
+                            }
+                            if (curr_weight + node_weight <= max_weight) {
+                                part_weight[static_cast<size_t>(own_part)].fetch_sub(node_weight);
+                                node_part[node].store(best_part, std::memory_order_relaxed);
+                                move_cnt.fetch_add(1, std::memory_order_relaxed);
+                            }
+                        }
+                        });
+
+                total_move_cnt += move_cnt.load();
+                if (move_cnt.load() == 0) {
+                    break;
+                }
+            }
+
+            for (size_t node = 0; node < node_cnt; ++node) {
+                partition[node] = node_part[node].load(std::memory_order_relaxed);
+            }
+            return total_move_cnt;
+        }
+
+    /**
+     * Refine a partition with one pass of k-way Fiduccia-Mattheyses (FM).
+     * Boundary nodes are moved to the part with the highest gain, even if the gain is negative,
+     * as long as the part stays within \p max_weight. Every node is moved at most once. The pass
+     * stops if the queue is empty, if many moves did not improve the cut or at \p deadline.
+     * Afterwards all moves after the best prefix are undone.
+     * @param evaluator The partition. This is changed.
+     * @param max_weight The maximum weight of a part.
+     * @param deadline The time at which the pass stops.
+     * @returns The number of moves which were kept.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        size_t refine_fm(
+                PartitionEvaluator<Id, NodeWeight, EdgeWeight>& evaluator,
+                NodeWeight max_weight,
+                std::chrono::steady_clock::time_point deadline) {
+            WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const& csr_graph = evaluator.csr_graph();
+            size_t const node_cnt = csr_graph.vwgt.size();
+
+            std::vector<EdgeWeight> connection(static_cast<size_t>(evaluator.part_cnt()), 0);
+            std::vector<Id> touched_parts;
+            // Find the feasible part with the highest gain for node, target is -1 if there is none.
+            auto best_move = [&](size_t node, Id& target) -> EdgeWeight {
+                for (size_t edge_idx = csr_graph.xadj[node]; edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                    size_t const to_node = static_cast<size_t>(csr_graph.adjncy[edge_idx]);
+                    if (to_node == node) {
+                        continue;
+                    }
+                    Id const to_part = evaluator.part(static_cast<Id>(to_node));
+                    if (connection[static_cast<size_t>(to_part)] == 0) {
+                        touched_parts.push_back(to_part);
+                    }
+                    connection[static_cast<size_t>(to_part)] += csr_graph.adjwgt[edge_idx];
+                }
+                Id const own_part = evaluator.part(static_cast<Id>(node));
+                target = -1;
+                for (auto const part : touched_parts) {
+                    if (part != own_part &&
+                            evaluator.part_weight(part) + csr_graph.vwgt[node] <= max_weight &&
+                            (target < 0 || connection[static_cast<size_t>(part)] > connection[static_cast<size_t>(target)])) {
+                        target = part;
+                    }
+                }
+                EdgeWeight const gain = (target < 0) ? 0 :
+                    connection[static_cast<size_t>(target)] - connection[static_cast<size_t>(own_part)];
+                for (auto const part : touched_parts) {
+                    connection[static_cast<size_t>(part)] = 0;
+                }
+                touched_parts.clear();
+                return gain;
+            };
+
+            std::priority_queue<std::pair<EdgeWeight, Id>> queue;
+            for (size_t node = 0; node < node_cnt; ++node) {
+                Id target;
+                EdgeWeight const gain = best_move(node, target);
+                if (target >= 0) {
+                    queue.emplace(gain, static_cast<Id>(node));
+                }
+            }
+
+            size_t const max_fruitless_move_cnt = std::max(static_cast<size_t>(50), node_cnt / 100);
+            std::vector<bool> is_locked(node_cnt, false);
+            std::vector<std::pair<Id, Id>> moves;
+            EdgeWeight const start_cut = evaluator.cut_cost();
+            EdgeWeight best_cut = start_cut;
+            size_t best_move_cnt = 0;
+            while (!queue.empty()) {
+                if (moves.size() % 64 == 0 && std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                EdgeWeight const queued_gain = queue.top().first;
+                size_t const node = static_cast<size_t>(queue.top().second);
+                queue.pop();
+                if (is_locked[node]) {
+                    continue;
+                }
+                Id target;
+                EdgeWeight const gain = best_move(node, target);
+                if (target < 0) {
+                    continue;
+                }
+                if (gain != queued_gain) {
+                    // The neighborhood changed since the node was queued.
+                    queue.emplace(gain, static_cast<Id>(node));
+                    continue;
+                }
+
+                moves.emplace_back(static_cast<Id>(node), evaluator.part(static_cast<Id>(node)));
+                evaluator.move(static_cast<Id>(node), target);
+                is_locked[node] = true;
+                if (evaluator.cut_cost() < best_cut) {
+                    best_cut = evaluator.cut_cost();
+                    best_move_cnt = moves.size();
+                } else if (moves.size() - best_move_cnt > max_fruitless_move_cnt) {
+                    break;
+                }
+
+                for (size_t edge_idx = csr_graph.xadj[node]; edge_idx < csr_graph.xadj[node + 1]; ++edge_idx) {
+                    size_t const to_node = static_cast<size_t>(csr_graph.adjncy[edge_idx]);
+                    if (!is_locked[to_node]) {
+                        Id to_target;
+                        EdgeWeight const to_gain = best_move(to_node, to_target);
+                        if (to_target >= 0) {
+                            queue.emplace(to_gain, static_cast<Id>(to_node));
+                        }
+                    }
+                }
+            }
+
+            while (moves.size() > best_move_cnt) {
+                evaluator.move(moves.back().first, moves.back().second);
+                moves.pop_back();
+            }
+            return best_move_cnt;
+        }
+
+    /**
+     * Repair the balance of a partition of \p graph which is only slightly imbalanced, e.g. a
+     * partition of the graph with scaled node weights. As long as a part is heavier than
+     * \p imbalance allows, the node of the heaviest part whose move increases the cut the least
+     * is moved to a part which stays within the bound. Ties are broken in favor of heavier nodes.
+     * If no node can be moved, the partition stays imbalanced, hence the imbalance should be
+     * checked afterwards. Each move takes time linear in the size of the graph times \p kparts,
+     * so this is not meant for heavily imbalanced partitions.
+     * @param graph The graph.
+     * @param result The partition to repair. This is changed and its cost is the cost on \p graph.
+     * @param kparts The number of parts.
+     * @param imbalance The maximum imbalance.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The number of moved nodes.
+     * @see graph::Graph::partition_scaled()
+     * @see graph::Graph::partition_imbalance()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        size_t rebalance_partition(
+                Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                PartitionResult<Id, EdgeWeight>& result,
+                Id kparts,
+                Rational const& imbalance,
+                size_t thread_cnt=0) {
+            WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const csr_graph = graph.to_weighted_csr_graph(thread_cnt);
+            PartitionEvaluator<Id, NodeWeight, EdgeWeight> evaluator(csr_graph, result.second, kparts, thread_cnt);
+            NodeWeight total_weight = 0;
+            for (Id part = 0; part < kparts; ++part) {
+                total_weight += evaluator.part_weight(part);
+            }
+            NodeWeight const max_weight = max_part_weight(total_weight, kparts, imbalance);
+
+            size_t move_cnt = 0;
+            while (true) {
+                Id heaviest_part = 0;
+                for (Id part = 1; part < kparts; ++part) {
+                    if (evaluator.part_weight(part) > evaluator.part_weight(heaviest_part)) {
+                        heaviest_part = part;
+                    }
+                }
+                if (evaluator.part_weight(heaviest_part) <= max_weight) {
+                    break;
+                }
+
+                Id best_node = -1;
+                Id best_target = -1;
+                EdgeWeight best_delta = 0;
+                for (size_t node = 0; node < csr_graph.vwgt.size(); ++node) {
+                    NodeWeight const node_weight = csr_graph.vwgt[node];
+                    if (evaluator.part(static_cast<Id>(node)) != heaviest_part || node_weight == 0) {
+                        continue;
+                    }
+                    for (Id target = 0; target < kparts; ++target) {
+                        if (target == heaviest_part || evaluator.part_weight(target) + node_weight > max_weight) {
+                            continue;
+                        }
+                        EdgeWeight const delta = evaluator.move_delta(static_cast<Id>(node), target);
+                        if (best_node < 0 || delta < best_delta || (delta == best_delta
+                                    && node_weight > csr_graph.vwgt[static_cast<size_t>(best_node)])) {
+                            best_node = static_cast<Id>(node);
+                            best_target = target;
+                            best_delta = delta;
+                        }
+                    }
+                }
+                if (best_node < 0) {
+                    break;
+                }
+                evaluator.move(best_node, best_target);
+                ++move_cnt;
+            }
+            result.first = evaluator.cut_cost();
+            result.second = evaluator.partition();
+            return move_cnt;
+        }
+
+    /**
+     * Refine a partition of \p graph within a time budget while keeping its balance.
+     * Every round consists of one round of size-constrained label propagation, which runs in
+     * parallel, followed by one FM pass. The rounds are repeated until a round does not reduce
+     * the cut or the time budget is used up. A round which increases the cut is undone. \n
+     * The partition may come from any method, e.g. from partitioning a spanning tree of
+     * \p graph. Afterwards the cost of \p result is its cost on \p graph.
+     * @param graph The graph.
+     * @param result The partition to refine. This is changed.
+     * @param kparts The number of parts.
+     * @param imbalance The maximum imbalance. Parts are never filled above the bound of the
+     *  tree partitioning.
+     * @param time_budget The time after which no new pass is started.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The statistics of each pass.
+     * @see graph::refine_label_propagation()
+     * @see graph::refine_fm()
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::vector<RefineRound<EdgeWeight>> refine_partition(
+                Graph<Id, NodeWeight, EdgeWeight> const& graph,
+                PartitionResult<Id, EdgeWeight>& result,
+                Id kparts,
+                Rational const& imbalance,
+                std::chrono::milliseconds time_budget,
+                size_t thread_cnt=0) {
+            using namespace std::chrono;
+            auto const deadline = steady_clock::now() + time_budget;
+            WeightedCsrGraph<Id, NodeWeight, EdgeWeight> const csr_graph = graph.to_weighted_csr_graph(thread_cnt);
+            PartitionEvaluator<Id, NodeWeight, EdgeWeight> evaluator(csr_graph, result.second, kparts, thread_cnt);
+            NodeWeight total_weight = 0;
+            for (Id part = 0; part < kparts; ++part) {
+                total_weight += evaluator.part_weight(part);
+            }
+            NodeWeight const max_weight = max_part_weight(total_weight, kparts, imbalance);
+
+            std::vector<RefineRound<EdgeWeight>> rounds;
+            while (steady_clock::now() < deadline) {
+                EdgeWeight const round_cut = evaluator.cut_cost();
+                std::vector<Id> round_partition(evaluator.partition());
+
+                auto start = steady_clock::now();
+                std::vector<Id> partition(round_partition);
+                size_t const lp_move_cnt = refine_label_propagation(csr_graph, partition, kparts, max_weight, 1, thread_cnt);
+                evaluator.assign(std::move(partition), thread_cnt);
+                rounds.push_back(RefineRound<EdgeWeight>{"label_propagation", round_cut, evaluator.cut_cost(),
+                        lp_move_cnt, duration_cast<milliseconds>(steady_clock::now() - start)});
+
+                start = steady_clock::now();
+                EdgeWeight const fm_cut = evaluator.cut_cost();
+                size_t const fm_move_cnt = refine_fm(evaluator, max_weight, deadline);
+                rounds.push_back(RefineRound<EdgeWeight>{"fm", fm_cut, evaluator.cut_cost(), fm_move_cnt,
+                        duration_cast<milliseconds>(steady_clock::now() - start)});
+
+                if (evaluator.cut_cost() > round_cut) {
+                    evaluator.assign(std::move(round_partition), thread_cnt);
+                }
+                if (evaluator.cut_cost() >= round_cut) {
+                    break;
+                }
+            }
+            result.first = evaluator.cut_cost();
+            result.second = evaluator.partition();
+            return rounds;
+        }
+}
@@ -0,0 +1,502 @@
+/**
+ * @file SnapConvert.hpp
+ * This file contains a converter from edge lists in the SNAP format to graphs in the METIS
+ * or the binary format which works in bounded memory.
+ * @see graphio::convert_snap_format()
+ */
+#pragma once
+
+#include<algorithm>
+#include<cstdint>
+#include<cstring>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<queue>
+#include<stdexcept>
+#include<string>
+#include<utility>
+#include<vector>
+
+#include "FileUtils.hpp"
+#include "GraphIo.hpp"
+
+namespace graphio {
+
+    /**
+     * Sorts values which do not need to fit into memory and removes duplicates.
+     * Values are collected in a buffer of bounded size. Full buffers are sorted and written to
+     * temporary files (runs) which are merged in the end.
+     * @tparam T The type of the values. Must be trivially copyable and less-than comparable.
+     */
+    template<typename T>
+        struct ExternalSorter {
+            private:
+                size_t capacity; /**< The maximum number of values in the buffer. */
+                std::string tmp_dir; /**< The directory for the runs. */
+                std::vector<T> buffer; /**< The values which were not written to a run yet. */
+                std::vector<std::unique_ptr<fileutils::TempFile>> runs; /**< The sorted runs. */
+
+                /**
+                 * Sort the buffer, remove duplicates and write it to a new run.
+                 */
+                void spill() {
+                    std::sort(this->buffer.begin(), this->buffer.end());
+                    this->buffer.erase(std::unique(this->buffer.begin(), this->buffer.end()), this->buffer.end());
+                    this->runs.emplace_back(new fileutils::TempFile(this->tmp_dir));
+                    this->runs.back()->write(this->buffer.data(), this->buffer.size() * sizeof(T));
+                    this->runs.back()->rewind();
+                    this->buffer.clear();
+                }
+
+            public:
+                /**
+                 * Constructor.
+                 * @param memory_budget The memory in bytes which may be used for buffering values.
+                 * @param tmp_dir The directory for the temporary files.
+                 */
+                ExternalSorter(size_t memory_budget, std::string tmp_dir) :
+                    capacity(std::max(memory_budget / sizeof(T), static_cast<size_t>(1024))), tmp_dir(tmp_dir) {}
+
+                /**
+                 * Add a value.
+                 * @param value The value.
+                 */
+                void push(T const& value) {
+                    if (this->buffer.size() == this->capacity) {
+                        this->spill();
+                    }
+                    this->buffer.push_back(value);
+                }
+
+                /**
+                 * Getter for the number of runs written so far.
+                 * @returns The number of runs.
+                 */
+                size_t run_cnt() const {
+                    return this->runs.size();
+                }
+
+                /**
+                 * Call \p body for every distinct value in ascending order.
+                 * The values are consumed, hence this can only be called once.
+                 * @param body A function taking a value.
+                 */
+                template<typename Body>
+                    void merge_unique(Body body) {
+                        if (this->runs.empty()) {
+                            std::sort(this->buffer.begin(), this->buffer.end());
+                            this->buffer.erase(std::unique(this->buffer.begin(), this->buffer.end()), this->buffer.end());
+                            for (auto const& value : this->buffer) {
+                                body(value);
+                            }
+                            std::vector<T>().swap(this->buffer);
+                            return;
+                        }
+
+                        if (!this->buffer.empty()) {
+                            this->spill();
+                        }
+                        std::vector<T>().swap(this->buffer);
+
+                        // Each run gets an equal share of the memory budget as read buffer.
+                        size_t const chunk_size = std::max(this->capacity / this->runs.size(), static_cast<size_t>(1024));
+                        std::vector<std::vector<T>> chunks(this->runs.size());
+                        std::vector<size_t> chunk_pos(this->runs.size(), 0);
+                        auto refill = [&](size_t run_idx) {
+                            chunks[run_idx].resize(chunk_size);
+                            size_t const read_cnt = this->runs[run_idx]->read(chunks[run_idx].data(), chunk_size * sizeof(T)) / sizeof(T);
+                            chunks[run_idx].resize(read_cnt);
+                            chunk_pos[run_idx] = 0;
+                            return read_cnt > 0;
+                        };
+
+                        using HeapEntry = std::pair<T, size_t>;
+                        auto compare = [](HeapEntry const& left, HeapEntry const& right) {
+                            return right.first < left.first;
+                        };
+                        std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(compare)> heap(compare);
+                        for (size_t run_idx = 0; run_idx < this->runs.size(); ++run_idx) {
+                            if (refill(run_idx)) {
+                                heap.emplace(chunks[run_idx][0], run_idx);
+                                chunk_pos[run_idx] = 1;
+                            }
+                        }
+
+                        bool has_prev = false;
+                        T prev = T();
+                        while (!heap.empty()) {
+                            HeapEntry const entry = heap.top();
+                            heap.pop();
+                            if (!has_prev || prev < entry.first) {
+                                body(entry.first);
+                                prev = entry.first;
+                                has_prev = true;
+                            }
+
+                            size_t const run_idx = entry.second;
+                            if (chunk_pos[run_idx] == chunks[run_idx].size() && !refill(run_idx)) {
+                                continue;
+                            }
+                            heap.emplace(chunks[run_idx][chunk_pos[run_idx]], run_idx);
+                            chunk_pos[run_idx] += 1;
+                        }
+                        this->runs.clear();
+                    }
+        };
+
+    /**
+     * A directed edge between two nodes with their ids from a SNAP file.
+     */
+    struct SnapEdge {
+        uint64_t from; /**< The source of the edge. */
+        uint64_t to; /**< The target of the edge. */
+
+        /**
+         * Lexicographic comparison.
+         * @param other The other edge.
+         * @returns True if this edge is smaller than \p other.
+         */
+        bool operator<(SnapEdge const& other) const {
+            return this->from < other.from || (this->from == other.from && this->to < other.to);
+        }
+
+        /**
+         * Equality comparison.
+         * @param other The other edge.
+         * @returns True if both edges have the same endpoints.
+         */
+        bool operator==(SnapEdge const& other) const {
+            return this->from == other.from && this->to == other.to;
+        }
+    };
+
+    /**
+     * Options for convert_snap_format().
+     */
+    struct SnapConvertOptions {
+        size_t memory_budget; /**< The memory in bytes used for sorting. */
+        std::string tmp_dir; /**< The directory for temporary files. */
+        bool has_header; /**< Indicates whether the first line is a header with node and edge count. */
+        bool is_binary; /**< Indicates whether the binary format is written instead of the METIS format. */
+
+        /**
+         * Constructor.
+         * @param memory_budget The memory in bytes used for sorting. Default: 1 GiB.
+         * @param tmp_dir The directory for temporary files. Default: /tmp.
+         * @param has_header Indicates whether the first line is a header. Default: true.
+         * @param is_binary Indicates whether the binary format is written. Default: false.
+         */
+        SnapConvertOptions(size_t memory_budget=(static_cast<size_t>(1) << 30), std::string tmp_dir="/tmp",
+                bool has_header=true, bool is_binary=false) :
+            memory_budget(memory_budget), tmp_dir(tmp_dir), has_header(has_header), is_binary(is_binary) {}
+    };
+
+    /**
+     * Statistics of a conversion with convert_snap_format().
+     */
+    struct SnapConvertStats {
+        uint64_t input_edge_cnt; /**< The number of edges in the input. */
+        uint64_t node_cnt; /**< The number of nodes in the output. */
+        uint64_t edge_cnt; /**< The number of distinct undirected edges in the output. */
+        size_t run_cnt; /**< The number of sorted runs written to temporary files. */
+    };
+
+    /**
+     * Call \p body for every edge of an edge list in the SNAP format.
+     * Empty lines and lines starting with # are ignored. The input is read in large blocks.
+     * @param is The input stream with the edge list.
+     * @param has_header Indicates whether the first line is a header with node and edge count.
+     * @param body A function taking a SnapEdge.
+     * @returns The number of edges.
+     *
+     * @throws std::invalid_argument if a line does not contain an edge.
+     */
+    template<typename Body>
+        uint64_t for_each_snap_edge(std::istream& is, bool has_header, Body body) {
+            // Incomplete lines at the end of a block are moved to the start of the buffer and
+            // completed by the next block.
+            std::vector<char> buffer(static_cast<size_t>(1) << 24);
+            size_t buffer_fill = 0;
+            size_t line_idx = 0;
+            uint64_t edge_cnt = 0;
+            bool is_header_pending = has_header;
+            bool is_eof = false;
+            while (!is_eof) {
+                is.read(buffer.data() + buffer_fill, static_cast<std::streamsize>(buffer.size() - buffer_fill));
+                buffer_fill += static_cast<size_t>(is.gcount());
+                is_eof = !is;
+                if (!is_eof && buffer_fill == buffer.size() &&
+                        find_line_end(buffer.data(), buffer.data() + buffer_fill) == buffer.data() + buffer_fill) {
+                    buffer.resize(buffer.size() * 2);
+                    continue;
+                }
+
+                char const* pos = buffer.data();
+                char const* const end = buffer.data() + buffer_fill;
+                while (pos != end) {
+                    char const* const line_end = find_line_end(pos, end);
+                    if (line_end == end && !is_eof) {
+                        break;
+                    }
+                    ++line_idx;
+
+                    char const* curr = pos;
+                    while (curr != line_end && is_space(*curr)) {
+                        ++curr;
+                    }
+                    if (curr != line_end && *curr != '#') {
+                        if (is_header_pending) {
+                            is_header_pending = false;
+                        } else {
+                            SnapEdge edge;
+                            if (!parse_int(curr, line_end, edge.from) || !parse_int(curr, line_end, edge.to)) {
+                                throw std::invalid_argument("Line " + std::to_string(line_idx) + " is not an edge.");
+                            }
+                            edge_cnt += 1;
+                            body(edge);
+                        }
+                    }
+                    pos = (line_end == end) ? end : line_end + 1;
+                }
+                buffer_fill = static_cast<size_t>(end - pos);
+                std::copy(pos, end, buffer.data());
+            }
+            return edge_cnt;
+        }
+
+    /**
+     * Append the decimal representation of \p value to \p str.
+     * @param str The string.
+     * @param value The value.
+     */
+    inline void append_uint(std::string& str, uint64_t value) {
+        char digits[20];
+        size_t digit_cnt = 0;
+        do {
+            digits[digit_cnt++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (digit_cnt > 0) {
+            str.push_back(digits[--digit_cnt]);
+        }
+    }
+
+    /**
+     * Copy a temporary file to an output stream.
+     * @param file The file which is rewound first.
+     * @param os The output stream.
+     * @returns The number of bytes copied.
+     */
+    inline uint64_t copy_to_stream(fileutils::TempFile& file, std::ostream& os) {
+        file.rewind();
+        std::vector<char> buffer(static_cast<size_t>(1) << 20);
+        uint64_t byte_cnt = 0;
+        for (size_t read_cnt = file.read(buffer.data(), buffer.size()); read_cnt > 0;
+                read_cnt = file.read(buffer.data(), buffer.size())) {
+            os.write(buffer.data(), static_cast<std::streamsize>(read_cnt));
+            byte_cnt += read_cnt;
+        }
+        return byte_cnt;
+    }
+
+    /**
+     * Write \p cnt copies of \p value and pad them with zeros to a multiple of eight bytes.
+     * @param os The output stream.
+     * @param cnt The number of copies.
+     * @param value The value.
+     */
+    template<typename T>
+        void write_repeated(std::ostream& os, uint64_t cnt, T value) {
+            std::vector<T> values(static_cast<size_t>(std::min(cnt, static_cast<uint64_t>(1) << 18)), value);
+            for (uint64_t written = 0; written < cnt; written += values.size()) {
+                uint64_t const block = std::min(cnt - written, static_cast<uint64_t>(values.size()));
+                os.write(reinterpret_cast<char const*>(values.data()), static_cast<std::streamsize>(block * sizeof(T)));
+            }
+            write_padding(os, cnt * sizeof(T));
+        }
+
+    /**
+     * Convert an edge list in the SNAP format into a graph.
+     * Every line contains the ids of the two endpoints of an edge. Empty lines and lines starting
+     * with # are ignored. The edges are treated as undirected, duplicate edges are removed and
+     * self loops are kept. All node and edge weights are one. \n
+     * The nodes are numbered by the order of their ids. The edges are sorted externally in
+     * \p options.memory_budget bytes. Additionally 8 bytes per node are needed to relabel the nodes.
+     * For the binary format the offsets of all nodes are kept during the merge as well, hence 16
+     * bytes per node are needed then.
+     * @param is The input stream with the edge list.
+     * @param os The output stream for the graph in the METIS or the binary format.
+     * @param options The options.
+     * @returns Statistics of the conversion.
+     *
+     * @throws std::invalid_argument if a line does not contain an edge.
+     * @throws std::out_of_range if the graph has more nodes than \p Id can represent.
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        SnapConvertStats convert_snap_format(std::istream& is, std::ostream& os, SnapConvertOptions const& options) {
+            SnapConvertStats stats = SnapConvertStats();
+            ExternalSorter<SnapEdge> edge_sorter(options.memory_budget / 4 * 3, options.tmp_dir);
+            ExternalSorter<uint64_t> node_sorter(options.memory_budget / 4, options.tmp_dir);
+
+            stats.input_edge_cnt = for_each_snap_edge(is, options.has_header, [&](SnapEdge const& edge) {
+                    edge_sorter.push(edge);
+                    node_sorter.push(edge.from);
+                    if (edge.from != edge.to) {
+                        edge_sorter.push(SnapEdge{edge.to, edge.from});
+                        node_sorter.push(edge.to);
+                    }
+                    });
+
+            std::vector<uint64_t> node_ids;
+            node_sorter.merge_unique([&node_ids](uint64_t node_id){ node_ids.push_back(node_id); });
+            if (node_ids.size() > static_cast<uint64_t>(std::numeric_limits<Id>::max())) {
+                throw std::out_of_range("The graph has too many nodes for the id type.");
+            }
+            stats.node_cnt = node_ids.size();
+            stats.run_cnt = edge_sorter.run_cnt() + node_sorter.run_cnt();
+
+            // The edges are sorted by their source, hence the adjacency lists are written node by node.
+            // Since the labels preserve the order of the ids, the edges are also sorted by the labels.
+            auto label_of = [&node_ids](uint64_t node_id) {
+                return static_cast<uint64_t>(std::lower_bound(node_ids.cbegin(), node_ids.cend(), node_id) - node_ids.cbegin());
+            };
+            fileutils::TempFile body(options.tmp_dir);
+            std::vector<uint64_t> xadj(options.is_binary ? node_ids.size() + 1 : 0, 0);
+            std::vector<Id> adjncy_block;
+            std::string lines;
+            uint64_t curr_label = 0;
+            uint64_t entry_cnt = 0;
+            uint64_t self_loop_cnt = 0;
+            bool is_line_open = false;
+
+            auto flush_body = [&]() {
+                if (options.is_binary) {
+                    body.write(adjncy_block.data(), adjncy_block.size() * sizeof(Id));
+                    adjncy_block.clear();
+                } else {
+                    body.write(lines.data(), lines.size());
+                    lines.clear();
+                }
+            };
+            edge_sorter.merge_unique([&](SnapEdge const& edge) {
+                    uint64_t const from = label_of(edge.from);
+                    uint64_t const to = label_of(edge.to);
+                    entry_cnt += 1;
+                    self_loop_cnt += (from == to) ? 1 : 0;
+                    if (options.is_binary) {
+                        xadj[from + 1] = entry_cnt;
+                        adjncy_block.push_back(static_cast<Id>(to));
+                        if (adjncy_block.size() == (static_cast<size_t>(1) << 18)) {
+                            flush_body();
+                        }
+                    } else {
+                        if (!is_line_open || curr_label != from) {
+                            if (is_line_open) {
+                                lines.push_back('\n');
+                            }
+                            lines.push_back('1');
+                            curr_label = from;
+                            is_line_open = true;
+                        }
+                        lines.push_back(' ');
+                        append_uint(lines, to);
+                        lines.append(" 1");
+                        if (lines.size() >= (static_cast<size_t>(1) << 20)) {
+                            flush_body();
+                        }
+                    }
+                    });
+            if (is_line_open) {
+                lines.push_back('\n');
+            }
+            flush_body();
+            stats.edge_cnt = (entry_cnt + self_loop_cnt) / 2;
+
+            if (options.is_binary) {
+                uint64_t const node_cnt = node_ids.size();
+                std::vector<uint64_t>().swap(node_ids);
+                for (uint64_t node = 0; node < node_cnt; ++node) {
+                    xadj[node + 1] = std::max(xadj[node + 1], xadj[node]);
+                }
+
+                BinaryGraphHeader header;
+                std::memset(&header, 0, sizeof(header));
+                std::copy(BINARY_GRAPH_MAGIC, BINARY_GRAPH_MAGIC + 8, header.magic);
+                header.version = BINARY_GRAPH_VERSION;
+                header.byte_order = 0x01020304;
+                header.id_size = sizeof(Id);
+                header.node_weight_size = sizeof(NodeWeight);
+                header.edge_weight_size = sizeof(EdgeWeight);
+                header.node_cnt = node_cnt;
+                header.entry_cnt = entry_cnt;
+                header.record_size = sizeof(header) +
+                    pad_to_eight((node_cnt + 1) * sizeof(uint64_t)) +
+                    pad_to_eight(entry_cnt * sizeof(Id)) +
+                    pad_to_eight(entry_cnt * sizeof(EdgeWeight)) +
+                    pad_to_eight(node_cnt * sizeof(NodeWeight));
+                os.write(reinterpret_cast<char const*>(&header), sizeof(header));
+                write_padded(os, xadj.data(), xadj.size() * sizeof(uint64_t));
+                std::vector<uint64_t>().swap(xadj);
+
+                uint64_t const adjncy_size = copy_to_stream(body, os);
+                write_padding(os, adjncy_size);
+
+                write_repeated(os, entry_cnt, static_cast<EdgeWeight>(1));
+                write_repeated(os, node_cnt, static_cast<NodeWeight>(1));
+            } else {
+                os << stats.node_cnt << " " << stats.edge_cnt << " 011" << '\n';
+                copy_to_stream(body, os);
+            }
+            os.flush();
+            return stats;
+        }
+
+    /**
+     * Read an edge list in the SNAP format into memory.
+     * The graph is the same as the one written by convert_snap_format(), but it is built in memory
+     * without temporary files.
+     * @param is The input stream with the edge list.
+     * @param has_header Indicates whether the first line is a header with node and edge count.
+     * @param thread_cnt The number of threads to use (default 0 for all hardware threads).
+     * @returns The graph.
+     *
+     * @throws std::invalid_argument if a line does not contain an edge.
+     * @throws std::out_of_range if the graph has more nodes than \p Id can represent.
+     * @see convert_snap_format()
+     */
+    template<typename Id=int32_t, typename NodeWeight=int32_t, typename EdgeWeight=int32_t>
+        graph::Graph<Id, NodeWeight, EdgeWeight> read_snap_graph(std::istream& is, bool has_header=true, size_t thread_cnt=0) {
+            std::vector<SnapEdge> edges;
+            std::vector<uint64_t> node_ids;
+            for_each_snap_edge(is, has_header, [&edges, &node_ids](SnapEdge const& edge) {
+                    edges.push_back(edge);
+                    node_ids.push_back(edge.from);
+                    if (edge.from != edge.to) {
+                        edges.push_back(SnapEdge{edge.to, edge.from});
+                        node_ids.push_back(edge.to);
+                    }
+                    });
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            std::sort(node_ids.begin(), node_ids.end());
+            node_ids.erase(std::unique(node_ids.begin(), node_ids.end()), node_ids.end());
+            if (node_ids.size() > static_cast<uint64_t>(std::numeric_limits<Id>::max())) {
+                throw std::out_of_range("The graph has too many nodes for the id type.");
+            }
+
+            auto label_of = [&node_ids](uint64_t node_id) {
+                return static_cast<size_t>(std::lower_bound(node_ids.cbegin(), node_ids.cend(), node_id) - node_ids.cbegin());
+            };
+            graph::WeightedCsrGraph<Id, NodeWeight, EdgeWeight> csr_graph;
+            csr_graph.xadj.assign(node_ids.size() + 1, 0);
+            csr_graph.adjncy.resize(edges.size());
+            csr_graph.adjwgt.assign(edges.size(), 1);
+            csr_graph.vwgt.assign(node_ids.size(), 1);
+            for (size_t edge_idx = 0; edge_idx < edges.size(); ++edge_idx) {
+                csr_graph.xadj[label_of(edges[edge_idx].from) + 1] = edge_idx + 1;
+                csr_graph.adjncy[edge_idx] = static_cast<Id>(label_of(edges[edge_idx].to));
+            }
+            return graph::Graph<Id, NodeWeight, EdgeWeight>(csr_graph, thread_cnt);
+        }
+}
@@ -8,13 +8,79 @@ namespace cut {
             parent_idx(parent_idx), children_idx_range(children_idx_range) {}
 
 
+    template<typename NodeWeight, typename EdgeWeight>
+        SignaturePruning<NodeWeight, EdgeWeight>::SignaturePruning(
+                EdgeWeight max_cut_cost, bool prune_unpackable,
+                std::vector<NodeWeight> const& lower_comp_weight_bounds, NodeWeight part_cnt) :
+            max_cut_cost(max_cut_cost), prune_unpackable(prune_unpackable), part_cnt(part_cnt),
+            part_capacity(lower_comp_weight_bounds.back()), comp_weights(lower_comp_weight_bounds),
+            max_comp_cnts(lower_comp_weight_bounds.size(), std::numeric_limits<NodeWeight>::max()) {
+            // The components of the first class are not packed optimally, hence they are not limited.
+            for (size_t comp_idx = 1; comp_idx < this->comp_weights.size(); ++comp_idx) {
+                if (this->comp_weights[comp_idx] > 0) {
+                    this->max_comp_cnts[comp_idx] = part_cnt * (this->part_capacity / this->comp_weights[comp_idx]);
+                }
+            }
+        }
+
+    template<typename NodeWeight, typename EdgeWeight>
+        bool SignaturePruning<NodeWeight, EdgeWeight>::is_unpackable(Signature<NodeWeight> const& sig) {
+            if (!this->prune_unpackable) {
+                return false;
+            }
+            NodeWeight total_comp_weight = 0;
+            NodeWeight heavy_comp_cnt = 0;
+            for (size_t comp_idx = 1; comp_idx < sig.size(); ++comp_idx) {
+                if (sig[comp_idx] > this->max_comp_cnts[comp_idx]) {
+                    this->packing_pruned_cnt += 1;
+                    return true;
+                }
+                total_comp_weight += sig[comp_idx] * this->comp_weights[comp_idx];
+                if (2 * this->comp_weights[comp_idx] > this->part_capacity) {
+                    heavy_comp_cnt += sig[comp_idx];
+                }
+            }
+            if (heavy_comp_cnt > this->part_cnt || total_comp_weight > this->part_cnt * this->part_capacity) {
+                this->packing_pruned_cnt += 1;
+                return true;
+            }
+            return false;
+        }
+
     template<typename Id, typename NodeWeight, typename EdgeWeight>
         Tree<Id, NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::build_tree(
                 std::map<Id, std::map<Id, EdgeWeight>> const& tree_map,
                 std::map<Id, NodeWeight> const& node_weight,
-                Id root_id
+                Id root_id,
+                ChildOrder child_order
                 ) {
 
+            // Calculate the weights of the subtrees with a DFS if the children are ordered by them.
+            std::map<Id, NodeWeight> subtree_weight_of;
+            if (child_order == ChildOrder::BY_SUBTREE_WEIGHT) {
+                std::vector<std::pair<Id, Id>> stack(1, std::make_pair(root_id, root_id));
+                std::vector<std::pair<Id, Id>> dfs_order;
+                while (!stack.empty()) {
+                    auto const curr = stack.back();
+                    stack.pop_back();
+                    dfs_order.push_back(curr);
+                    auto const neighbors_it = tree_map.find(curr.first);
+                    if (neighbors_it != tree_map.cend()) {
+                        for (auto const& neighbor : neighbors_it->second) {
+                            if (curr.first == root_id || neighbor.first != curr.second) {
+                                stack.emplace_back(neighbor.first, curr.first);
+                            }
+                        }
+                    }
+                }
+                for (auto it = dfs_order.crbegin(); it != dfs_order.crend(); ++it) {
+                    subtree_weight_of[it->first] += node_weight.at(it->first);
+                    if (it->first != root_id) {
+                        subtree_weight_of[it->second] += subtree_weight_of[it->first];
+                    }
+                }
+            }
+
             Tree<Id, int, EdgeWeight> tree;
             // Use a struct to represent an incomplete node since the child_idx_range is not known.
             struct NodeStub {
@@ -49,15 +115,25 @@ namespace cut {
                 // Save the index of the first child.
                 size_t old_next_child_idx = next_child_idx;
                 if (tree_map.find(curr_node.id) != tree_map.cend()) {
+                    std::vector<std::pair<Id, EdgeWeight>> children;
                     for (auto const neighbor : tree_map.at(curr_node.id)) {
                         // Check if neighbor is the parent.
                         if (curr_node.level == 0 || neighbor.first != tree.levels[curr_node.level - 1][curr_node.parent_idx].id) {
-                            bool curr_has_left_sibling = !(old_next_child_idx == next_child_idx);
-                            queue.emplace_back(neighbor.first, neighbor.second, node_weight.at(neighbor.first),
-                                    tree.levels[curr_node.level].size(), curr_has_left_sibling, curr_node.level + 1); 
-                            ++next_child_idx;
+                            children.push_back(neighbor);
                         }
                     }
+                    if (child_order == ChildOrder::BY_SUBTREE_WEIGHT) {
+                        std::stable_sort(children.begin(), children.end(),
+                                [&subtree_weight_of](std::pair<Id, EdgeWeight> const& lhs, std::pair<Id, EdgeWeight> const& rhs){
+                                return subtree_weight_of.at(lhs.first) < subtree_weight_of.at(rhs.first);
+                                });
+                    }
+                    for (auto const& child : children) {
+                        bool curr_has_left_sibling = !(old_next_child_idx == next_child_idx);
+                        queue.emplace_back(child.first, child.second, node_weight.at(child.first),
+                                tree.levels[curr_node.level].size(), curr_has_left_sibling, curr_node.level + 1); 
+                        ++next_child_idx;
+                    }
                 }
 
                 tree.levels[curr_node.level].emplace_back(curr_node.id, curr_node.parent_edge_weight, curr_node.weight,
@@ -90,131 +166,541 @@ namespace cut {
             }
         }
 
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        Tree<Id, NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::coarsen_weights(NodeWeight granularity) const {
+            if (granularity < 1) {
+                throw std::invalid_argument("The granularity of the node weights must be positive.");
+            }
+
+            return this->with_node_weights([granularity](NodeWeight weight) {
+                    return (weight + granularity - 1) / granularity;
+                    });
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        Tree<Id, NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::scale_weights(Rational factor) const {
+            if (factor <= 0) {
+                throw std::invalid_argument("The factor of the node weights must be positive.");
+            }
+
+            // A node with a positive weight keeps at least weight one, otherwise it would not count for the
+            // balance of the scaled tree.
+            return this->with_node_weights([&factor](NodeWeight weight) {
+                    NodeWeight const scaled_weight =
+                        gmputils::floor_to_int<NodeWeight>(Rational(weight) * factor + Rational(1, 2));
+                    return (weight > 0) ? std::max(scaled_weight, static_cast<NodeWeight>(1)) : scaled_weight;
+                    });
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        Tree<Id, NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::with_node_weights(
+                std::function<NodeWeight(NodeWeight)> const& node_weight) const {
+            Tree<Id, NodeWeight, EdgeWeight> tree;
+            tree.has_left_sibling = this->has_left_sibling;
+            for (auto const& lvl : this->levels) {
+                tree.levels.push_back(std::vector<Node>());
+                tree.levels.back().reserve(lvl.size());
+                for (auto const& node : lvl) {
+                    tree.levels.back().emplace_back(node.id, node.parent_edge_weight,
+                            node_weight(node.weight), node.parent_idx, node.children_idx_range);
+                }
+            }
+            tree.calculate_subtree_weights();
+
+            return tree;
+        }
+
     template<typename Id, typename NodeWeight, typename EdgeWeight>
         SignatureMap<NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::cut_at_node(
                 Tree::Node const& node, 
                 NodeWeight node_subtree_weight,
-                NodeWeight left_siblings_weight,
                 Tree::SignatureMap const& left_sibling_sigs, 
                 Tree::SignatureMap const& right_child_sigs, 
-                std::vector<NodeWeight> const& comp_weight_bounds) {
+                std::vector<NodeWeight> const& comp_weight_bounds,
+                SignaturePruning<NodeWeight, EdgeWeight>& pruning) {
 
-            // The maximum amount node weight for a signature is left_siblings_weight plus the node_subtree_weight. 
-            // Furthermore, we need to add 1 since weight 0 is possible.
-            Tree::SignatureMap node_sigs(
-                    static_cast<size_t>(left_siblings_weight + node_subtree_weight + 1));
+            Tree::SignatureMap node_sigs;
 
             // Iterate over all calculated signatures of the left sibling and the rightmost child according
             // to the dynamic programming scheme described in the paper FF13.
-            for (NodeWeight left_sibling_weight_cnt = 0; 
-                    static_cast<size_t>(left_sibling_weight_cnt) < left_sibling_sigs.size(); 
-                    ++left_sibling_weight_cnt) {
-
-                auto const& left_sibling_sigs_with_node_weight = left_sibling_sigs[static_cast<size_t>(left_sibling_weight_cnt)];
-
-                for (NodeWeight child_weight_cnt = 0; 
-                        static_cast<size_t>(child_weight_cnt) < right_child_sigs.size(); ++child_weight_cnt) {
+            for (auto const& left_sibling_sigs_with_weight : left_sibling_sigs) {
+                NodeWeight const left_sibling_weight_cnt = left_sibling_sigs_with_weight.first;
 
-                    auto const& child_sigs_with_node_weight = right_child_sigs[static_cast<size_t>(child_weight_cnt)];
+                for (auto const& child_sigs_with_weight : right_child_sigs) {
+                    NodeWeight const child_weight_cnt = child_sigs_with_weight.first;
+
+                    // The frontier weights of both cases only depend on the weights of the two maps, hence
+                    // the signatures of the node with these weights are looked up once.
+                    auto& uncut_node_sigs = node_sigs[left_sibling_weight_cnt + child_weight_cnt];
+                    NodeWeight const node_comp_weight = node_subtree_weight - child_weight_cnt;
+                    // Check if the current weight of the component which includes the current node is smaller than
+                    // the maximum allowed weight.
+                    bool const can_cut_parent_edge = node_comp_weight < comp_weight_bounds.back();
+                    size_t node_comp_idx = 0;
+                    while (can_cut_parent_edge && node_comp_weight >= comp_weight_bounds[node_comp_idx]) {
+                        ++node_comp_idx;
+                    }
+                    auto* const cut_node_sigs = can_cut_parent_edge ?
+                        &node_sigs[left_sibling_weight_cnt + node_subtree_weight] : nullptr;
 
-                    for (auto const& left_sibling_sig : left_sibling_sigs_with_node_weight) {
-                        for (auto const& child_sig : child_sigs_with_node_weight) {
+                    for (auto const& left_sibling_sig : left_sibling_sigs_with_weight.second) {
+                        for (auto const& child_sig : child_sigs_with_weight.second) {
                             // First case: The edge from the current node to its parent is not cut.
-                            NodeWeight frontier_weight = left_sibling_weight_cnt + child_weight_cnt;
-                            size_t frontier_weight_st = static_cast<size_t>(frontier_weight);
                             EdgeWeight cut_cost = left_sibling_sig.second + child_sig.second;
+                            if (pruning.exceeds_cut_cost(cut_cost)) {
+                                continue;
+                            }
                             Tree::Signature sig = left_sibling_sig.first + child_sig.first;
+                            if (pruning.is_unpackable(sig)) {
+                                continue;
+                            }
 
-                            auto prev_cut_cost_it = node_sigs[frontier_weight_st].find(sig);
-                            if (prev_cut_cost_it == node_sigs[frontier_weight_st].end()
+                            auto prev_cut_cost_it = uncut_node_sigs.find(sig);
+                            if (prev_cut_cost_it == uncut_node_sigs.end()
                                     || cut_cost < prev_cut_cost_it->second) {
-                                node_sigs[frontier_weight_st][sig] = cut_cost;
+                                uncut_node_sigs[sig] = cut_cost;
                             }
 
                             // Second case: The edge from the current node to its parent is cut.
-                            NodeWeight const node_comp_weight = node_subtree_weight - child_weight_cnt;
-                            // Check if the current weight of the component which includes the current node is smaller than
-                            // the maximum allowed weight.
-                            if (node_comp_weight >= comp_weight_bounds.back()) {
+                            if (!can_cut_parent_edge
+                                    || pruning.exceeds_cut_cost(cut_cost + node.parent_edge_weight)) {
                                 continue;
                             } else {
-                                frontier_weight += node_comp_weight;
-                                frontier_weight_st = static_cast<size_t>(frontier_weight);
                                 cut_cost += node.parent_edge_weight;
 
                                 // Adjust the signature to account for the component which contains the current node.
-                                size_t i = 0; 
-                                while (node_comp_weight >= comp_weight_bounds[i]) { ++i; }
-                                sig[i] += 1;
+                                sig[node_comp_idx] += 1;
+                                if (pruning.is_unpackable(sig)) {
+                                    continue;
+                                }
 
-                                prev_cut_cost_it = node_sigs[frontier_weight_st].find(sig);
-                                if (prev_cut_cost_it == node_sigs[frontier_weight_st].end()
+                                prev_cut_cost_it = cut_node_sigs->find(sig);
+                                if (prev_cut_cost_it == cut_node_sigs->end()
                                         || cut_cost < prev_cut_cost_it->second) {
-                                    node_sigs[frontier_weight_st][sig] = cut_cost;
+                                    (*cut_node_sigs)[sig] = cut_cost;
                                 }
                             }
                         }
                     }
                 }
             }
+
+            // Drop the weights whose signatures were all pruned.
+            for (auto sigs_with_weight_it = node_sigs.begin(); sigs_with_weight_it != node_sigs.end();) {
+                if (sigs_with_weight_it->second.empty()) {
+                    sigs_with_weight_it = node_sigs.erase(sigs_with_weight_it);
+                } else {
+                    ++sigs_with_weight_it;
+                }
+            }
             return node_sigs;
         }
 
 
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        SignatureMap<NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::cut_at_chain_node(
+                Tree::Node const& node,
+                NodeWeight node_subtree_weight,
+                Tree::SignatureMap sigs,
+                bool sigs_of_child,
+                std::vector<NodeWeight> const& comp_weight_bounds,
+                SignaturePruning<NodeWeight, EdgeWeight>& pruning) {
+
+            // First case: The edge from the current node to its parent is not cut. Then the signatures
+            // are exactly the given ones since the other map only contains the 0-vector.
+            Tree::SignatureMap node_sigs(std::move(sigs));
+
+            // Second case: The edge from the current node to its parent is cut. The new signatures are
+            // collected separately since they may belong to a weight which is still iterated.
+            std::vector<std::pair<NodeWeight, std::pair<Tree::Signature, EdgeWeight>>> cut_sigs;
+            for (auto const& sigs_with_weight : node_sigs) {
+                NodeWeight const weight_cnt = sigs_with_weight.first;
+                NodeWeight const node_comp_weight = sigs_of_child ?
+                    node_subtree_weight - weight_cnt : node_subtree_weight;
+                if (node_comp_weight >= comp_weight_bounds.back()) {
+                    continue;
+                }
+                size_t i = 0;
+                while (node_comp_weight >= comp_weight_bounds[i]) { ++i; }
+                NodeWeight const frontier_weight = weight_cnt + node_comp_weight;
+                for (auto const& sig : sigs_with_weight.second) {
+                    if (pruning.exceeds_cut_cost(sig.second + node.parent_edge_weight)) {
+                        continue;
+                    }
+                    Tree::Signature cut_sig(sig.first);
+                    cut_sig[i] += 1;
+                    if (pruning.is_unpackable(cut_sig)) {
+                        continue;
+                    }
+                    cut_sigs.emplace_back(frontier_weight,
+                            std::make_pair(std::move(cut_sig), sig.second + node.parent_edge_weight));
+                }
+            }
+
+            // The cut signatures are ordered by their weight, hence the signatures of the node with
+            // this weight are only looked up when it changes.
+            typename Tree::SignatureMap::mapped_type* sigs_with_weight = nullptr;
+            for (size_t cut_sig_idx = 0; cut_sig_idx < cut_sigs.size(); ++cut_sig_idx) {
+                auto& cut_sig = cut_sigs[cut_sig_idx];
+                if (cut_sig_idx == 0 || cut_sig.first != cut_sigs[cut_sig_idx - 1].first) {
+                    sigs_with_weight = &node_sigs[cut_sig.first];
+                }
+                auto prev_cut_cost_it = sigs_with_weight->find(cut_sig.second.first);
+                if (prev_cut_cost_it == sigs_with_weight->end()) {
+                    sigs_with_weight->emplace(std::move(cut_sig.second.first), cut_sig.second.second);
+                } else if (cut_sig.second.second < prev_cut_cost_it->second) {
+                    prev_cut_cost_it->second = cut_sig.second.second;
+                }
+            }
+            return node_sigs;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        SignatureMap<NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::cut_at_leaf_run(
+                std::vector<Tree::Node> const& level,
+                size_t run_begin_idx,
+                size_t run_end_idx,
+                Tree::SignatureMap sigs,
+                std::vector<NodeWeight> const& comp_weight_bounds,
+                SignaturePruning<NodeWeight, EdgeWeight>& pruning) {
+
+            std::map<std::pair<NodeWeight, EdgeWeight>, size_t> leaf_cnt_of_group;
+            for (size_t leaf_idx = run_begin_idx; leaf_idx <= run_end_idx; ++leaf_idx) {
+                leaf_cnt_of_group[std::make_pair(level[leaf_idx].weight, level[leaf_idx].parent_edge_weight)] += 1;
+            }
+
+            for (auto const& group : leaf_cnt_of_group) {
+                NodeWeight const leaf_weight = group.first.first;
+                EdgeWeight const leaf_edge_weight = group.first.second;
+                // A leaf can only be cut off if it fits into a component on its own.
+                if (leaf_weight >= comp_weight_bounds.back()) {
+                    continue;
+                }
+                size_t i = 0;
+                while (leaf_weight >= comp_weight_bounds[i]) { ++i; }
+
+                // Each signature is extended by cutting off 0 up to all leaves of the group.
+                Tree::SignatureMap group_sigs;
+                for (auto const& sigs_with_weight : sigs) {
+                    // All signatures of a weight are extended to the same weights, hence the signatures
+                    // with these weights are looked up once.
+                    std::vector<typename Tree::SignatureMap::mapped_type*> group_sigs_with_weight(
+                            group.second + 1, nullptr);
+                    for (auto const& sig : sigs_with_weight.second) {
+                        Tree::Signature cut_sig(sig.first);
+                        EdgeWeight cut_cost = sig.second;
+                        NodeWeight frontier_weight = sigs_with_weight.first;
+                        for (size_t cut_cnt = 0; cut_cnt <= group.second; ++cut_cnt) {
+                            // The signature only gets worse with each further cut leaf.
+                            if (cut_cnt > 0 && (pruning.exceeds_cut_cost(cut_cost) || pruning.is_unpackable(cut_sig))) {
+                                break;
+                            }
+                            if (group_sigs_with_weight[cut_cnt] == nullptr) {
+                                group_sigs_with_weight[cut_cnt] = &group_sigs[frontier_weight];
+                            }
+                            auto& cut_sigs_with_weight = *group_sigs_with_weight[cut_cnt];
+                            auto prev_cut_cost_it = cut_sigs_with_weight.find(cut_sig);
+                            if (prev_cut_cost_it == cut_sigs_with_weight.end()) {
+                                cut_sigs_with_weight.emplace(cut_sig, cut_cost);
+                            } else if (cut_cost < prev_cut_cost_it->second) {
+                                prev_cut_cost_it->second = cut_cost;
+                            }
+                            cut_sig[i] += 1;
+                            cut_cost += leaf_edge_weight;
+                            frontier_weight += leaf_weight;
+                        }
+                    }
+                }
+                sigs = std::move(group_sigs);
+            }
+            return sigs;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        size_t Tree<Id, NodeWeight, EdgeWeight>::truncate_to_beam(Tree::SignatureMap& sigs, size_t beam_width) {
+            using SignatureWithCost = std::pair<EdgeWeight, Tree::Signature const*>;
+            auto const by_cost = [](SignatureWithCost const& lhs, SignatureWithCost const& rhs) {
+                return lhs.first < rhs.first;
+            };
+
+            size_t dropped_cnt = 0;
+            for (auto& weight_and_sigs : sigs) {
+                auto& sigs_with_weight = weight_and_sigs.second;
+                if (sigs_with_weight.size() <= beam_width) {
+                    continue;
+                }
+
+                // Group the signatures by the class of their heaviest component.
+                std::map<size_t, std::vector<SignatureWithCost>> groups;
+                for (auto const& sig : sigs_with_weight) {
+                    size_t heaviest_class = sig.first.size();
+                    while (heaviest_class > 0 && sig.first[heaviest_class - 1] == 0) {
+                        --heaviest_class;
+                    }
+                    groups[heaviest_class].emplace_back(sig.second, &sig.first);
+                }
+                for (auto& group : groups) {
+                    std::sort(group.second.begin(), group.second.end(), by_cost);
+                }
+
+                // In each round take the next cheapest signature of every group, cheapest first.
+                typename Tree::SignatureMap::mapped_type kept_sigs;
+                for (size_t rank = 0; kept_sigs.size() < beam_width; ++rank) {
+                    std::vector<SignatureWithCost> round;
+                    for (auto const& group : groups) {
+                        if (rank < group.second.size()) {
+                            round.push_back(group.second[rank]);
+                        }
+                    }
+                    std::sort(round.begin(), round.end(), by_cost);
+                    for (auto const& sig : round) {
+                        if (kept_sigs.size() == beam_width) {
+                            break;
+                        }
+                        kept_sigs.emplace(*sig.second, sig.first);
+                    }
+                }
+                dropped_cnt += sigs_with_weight.size() - kept_sigs.size();
+                sigs_with_weight = std::move(kept_sigs);
+            }
+            return dropped_cnt;
+        }
+
     template<typename Id, typename NodeWeight, typename EdgeWeight>
         SignaturesForTree<Id, NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::cut(
                 Rational eps, NodeWeight part_cnt, bool delete_signatures) {
+            CutOptions options;
+            options.delete_signatures = delete_signatures;
+            return this->cut(eps, part_cnt, options);
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        double Tree<Id, NodeWeight, EdgeWeight>::estimate_cut_work() const {
+            // The signature map at a node has at most one entry per weight up to the accumulated weight of
+            // the subtrees rooted at the node and at its left siblings.
+            std::vector<std::vector<double>> map_size;
+            for (size_t lvl_idx = 0; lvl_idx < this->levels.size(); ++lvl_idx) {
+                map_size.emplace_back(this->levels[lvl_idx].size());
+                NodeWeight forest_weight = 0;
+                for (size_t node_idx = 0; node_idx < this->levels[lvl_idx].size(); ++node_idx) {
+                    if (!this->has_left_sibling[lvl_idx][node_idx]) {
+                        forest_weight = 0;
+                    }
+                    forest_weight += this->subtree_weight[lvl_idx][node_idx];
+                    map_size[lvl_idx][node_idx] = static_cast<double>(forest_weight) + 1;
+                }
+            }
+
+            double work = 0;
+            for (size_t lvl_idx = 1; lvl_idx < this->levels.size(); ++lvl_idx) {
+                for (size_t node_idx = 0; node_idx < this->levels[lvl_idx].size(); ++node_idx) {
+                    Tree::Node const& node = this->levels[lvl_idx][node_idx];
+                    double const left_sibling_size = this->has_left_sibling[lvl_idx][node_idx] ?
+                        map_size[lvl_idx][node_idx - 1] : 1;
+                    double const child_size = (node.children_idx_range.first < node.children_idx_range.second) ?
+                        map_size[lvl_idx + 1][node.children_idx_range.second - 1] : 1;
+                    work += left_sibling_size * child_size;
+                }
+            }
+            return work;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::vector<std::vector<size_t>> Tree<Id, NodeWeight, EdgeWeight>::forest_classes() const {
+            std::vector<std::vector<size_t>> classes;
+            for (auto const& lvl : this->levels) {
+                classes.emplace_back(lvl.size(), 0);
+            }
+
+            std::map<std::tuple<size_t, size_t, NodeWeight, EdgeWeight>, size_t> class_of_key;
+            for (size_t lvl_idx = this->levels.size() - 1; lvl_idx > 0; --lvl_idx) {
+                for (size_t node_idx = 0; node_idx < this->levels[lvl_idx].size(); ++node_idx) {
+                    Tree::Node const& node = this->levels[lvl_idx][node_idx];
+                    size_t const left_sibling_class = this->has_left_sibling[lvl_idx][node_idx] ?
+                        classes[lvl_idx][node_idx - 1] : 0;
+                    size_t const child_class = (node.children_idx_range.first < node.children_idx_range.second) ?
+                        classes[lvl_idx + 1][node.children_idx_range.second - 1] : 0;
+                    auto const key = std::make_tuple(left_sibling_class, child_class, node.weight, node.parent_edge_weight);
+                    auto const class_it = class_of_key.emplace(key, class_of_key.size() + 1).first;
+                    classes[lvl_idx][node_idx] = class_it->second;
+                }
+            }
+            return classes;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        SignaturesForTree<Id, NodeWeight, EdgeWeight> Tree<Id, NodeWeight, EdgeWeight>::cut(
+                Rational eps, NodeWeight part_cnt, CutOptions const& options) {
+            bool const delete_signatures = options.delete_signatures;
 
             std::vector<std::vector<Tree::SignatureMap>> signatures;
             for (auto const& lvl : this->levels) {
                 signatures.emplace_back(lvl.size());
             }
 
+            // Isomorphic forests have the same signatures, hence the signatures of a class are cached
+            // until the last node of the class is processed. If the signatures are deleted anyway, the
+            // nodes of a class share the cached map instead of holding a copy of it.
+            CutStatistics statistics;
+            std::vector<std::vector<size_t>> classes;
+            std::unordered_map<size_t, size_t> remaining_class_cnt;
+            std::unordered_map<size_t, std::shared_ptr<Tree::SignatureMap const>> class_sigs;
+            std::vector<std::vector<std::shared_ptr<Tree::SignatureMap const>>> shared_sigs;
+            if (options.memoize_isomorphic) {
+                classes = this->forest_classes();
+                if (delete_signatures) {
+                    for (auto const& lvl : this->levels) {
+                        shared_sigs.emplace_back(lvl.size());
+                    }
+                }
+                for (size_t lvl_idx = 1; lvl_idx < classes.size(); ++lvl_idx) {
+                    for (auto const node_class : classes[lvl_idx]) {
+                        remaining_class_cnt[node_class] += 1;
+                    }
+                }
+                statistics.class_cnt = remaining_class_cnt.size();
+            }
+
             // Calculate the size intervals of the connected components of a signature.
             std::vector<NodeWeight> const comp_weight_bounds = 
                 calculate_upper_component_weight_bounds(eps, this->subtree_weight[0][0], part_cnt);
 
+            bool const aggregate_leaf_runs = delete_signatures && options.aggregate_leaf_runs;
+            SignaturePruning<NodeWeight, EdgeWeight> pruning(
+                    (options.max_cut_cost < static_cast<double>(std::numeric_limits<EdgeWeight>::max())) ?
+                    static_cast<EdgeWeight>(options.max_cut_cost) : std::numeric_limits<EdgeWeight>::max(),
+                    options.prune_unpackable,
+                    calculate_lower_component_weight_bounds(eps, this->subtree_weight[0][0], part_cnt),
+                    part_cnt);
+            auto const is_leaf = [this](size_t lvl_idx, size_t node_idx) -> bool {
+                auto const& children_idx_range = this->levels[lvl_idx][node_idx].children_idx_range;
+                return children_idx_range.first == children_idx_range.second;
+            };
+
+            // The signature which contains 0 nodes, is the 0-vector and has 0 cut cost is
+            // always present, even if the node does not exist.
+            Tree::SignatureMap empty_map;
+            empty_map[0].emplace(Signature(comp_weight_bounds.size()), 0);
+
+            auto const is_shared = [&shared_sigs](size_t lvl_idx, size_t node_idx) -> bool {
+                return !shared_sigs.empty() && shared_sigs[lvl_idx][node_idx] != nullptr;
+            };
+            auto const sigs_at = [&](size_t lvl_idx, size_t node_idx) -> Tree::SignatureMap const& {
+                return is_shared(lvl_idx, node_idx) ? *shared_sigs[lvl_idx][node_idx] : signatures[lvl_idx][node_idx];
+            };
+            // The signatures of a node are only moved if they are neither shared nor kept.
+            auto const take_sigs = [&](size_t lvl_idx, size_t node_idx) -> Tree::SignatureMap {
+                if (is_shared(lvl_idx, node_idx)) {
+                    return *shared_sigs[lvl_idx][node_idx];
+                }
+                return delete_signatures ? std::move(signatures[lvl_idx][node_idx]) : signatures[lvl_idx][node_idx];
+            };
+
             // Iterate over all nodes except the root starting with the node one the bottom left.
             for (size_t lvl_idx = this->levels.size() - 1; lvl_idx > 0; --lvl_idx) {
-                NodeWeight left_siblings_weight = 0; 
                 for (size_t node_idx = 0; node_idx < this->levels[lvl_idx].size(); ++node_idx) {
+                    if (options.cancel != nullptr && options.cancel->load(std::memory_order_relaxed)) {
+                        throw CutCancelledException();
+                    }
+
+                    // A run of adjacent leaf siblings is handled at its last leaf. The signatures of the
+                    // other leaves of the run are never calculated.
+                    size_t const run_begin_idx = node_idx;
+                    if (aggregate_leaf_runs && is_leaf(lvl_idx, node_idx)) {
+                        while (node_idx + 1 < this->levels[lvl_idx].size() && is_leaf(lvl_idx, node_idx + 1)
+                                && this->has_left_sibling[lvl_idx][node_idx + 1]) {
+                            ++node_idx;
+                        }
+                    }
+                    for (size_t leaf_idx = run_begin_idx; leaf_idx < node_idx; ++leaf_idx) {
+                        statistics.node_cnt += 1;
+                        statistics.aggregated_leaf_cnt += 1;
+                        if (options.memoize_isomorphic) {
+                            size_t const leaf_class = classes[lvl_idx][leaf_idx];
+                            size_t& remaining_cnt = remaining_class_cnt[leaf_class];
+                            remaining_cnt -= 1;
+                            if (remaining_cnt == 0) {
+                                class_sigs.erase(leaf_class);
+                            }
+                        }
+                    }
+
                     Tree::Node const& node = this->levels[lvl_idx][node_idx];
                     NodeWeight const node_subtree_weight = this->subtree_weight[lvl_idx][node_idx];
-                    bool const node_has_left_sibling = this->has_left_sibling[lvl_idx][node_idx];
+                    bool const node_has_left_sibling = this->has_left_sibling[lvl_idx][run_begin_idx];
                     bool const node_has_child = node.children_idx_range.first < node.children_idx_range.second;
 
-                    // The signature which contains 0 nodes, is the 0-vector and has 0 cut cost is
-                    // always present, even if the node does not exist.
-                    Tree::SignatureMap const empty_map({{{{Signature(comp_weight_bounds.size()), 0}}}});
-
                     Tree::SignatureMap const* left_sibling_sigs = &empty_map;
                     Tree::SignatureMap const* child_sigs = &empty_map;
 
                     // Adjust the reference to the signatures if the node has a left sibling or
                     // has a child respectively.
-                    // TODO: Think about optimizing the case where there is no left sibling or there is no child.
-                    // At the moment we are adding the 0-vector to all signatures calculated beforehand which is 
-                    // unnecessary.
                     if (node_has_left_sibling) {
-                        left_sibling_sigs = &signatures[lvl_idx][node_idx - 1];
+                        left_sibling_sigs = &sigs_at(lvl_idx, run_begin_idx - 1);
                     }
                     if (node_has_child) {
-                        child_sigs = &signatures[lvl_idx + 1][node.children_idx_range.second - 1];
+                        child_sigs = &sigs_at(lvl_idx + 1, node.children_idx_range.second - 1);
                     }
 
 
-                    signatures[lvl_idx][node_idx] = cut_at_node(node, node_subtree_weight, left_siblings_weight,
-                            *left_sibling_sigs, *child_sigs, comp_weight_bounds);
-                    left_siblings_weight += node_subtree_weight;
+                    statistics.node_cnt += 1;
+                    size_t const node_class = options.memoize_isomorphic ? classes[lvl_idx][node_idx] : 0;
+                    auto const cached_sigs_it = class_sigs.find(node_class);
+                    if (cached_sigs_it != class_sigs.end()) {
+                        if (delete_signatures) {
+                            shared_sigs[lvl_idx][node_idx] = cached_sigs_it->second;
+                        } else {
+                            signatures[lvl_idx][node_idx] = *cached_sigs_it->second;
+                        }
+                        statistics.cache_hit_cnt += 1;
+                    } else if (run_begin_idx < node_idx) {
+                        statistics.aggregated_leaf_cnt += 1;
+                        Tree::SignatureMap run_sigs = node_has_left_sibling ?
+                            take_sigs(lvl_idx, run_begin_idx - 1) : empty_map;
+                        signatures[lvl_idx][node_idx] = cut_at_leaf_run(this->levels[lvl_idx], run_begin_idx, node_idx,
+                                std::move(run_sigs), comp_weight_bounds, pruning);
+                    } else if ((node_has_left_sibling && node_has_child) || !options.compress_chains) {
+                        signatures[lvl_idx][node_idx] = cut_at_node(node, node_subtree_weight,
+                                *left_sibling_sigs, *child_sigs, comp_weight_bounds, pruning);
+                    } else {
+                        // The signatures of the single predecessor can be reused if they are deleted anyway.
+                        Tree::SignatureMap chain_sigs = node_has_child ?
+                            take_sigs(lvl_idx + 1, node.children_idx_range.second - 1) :
+                            (node_has_left_sibling ? take_sigs(lvl_idx, node_idx - 1) : empty_map);
+                        signatures[lvl_idx][node_idx] = cut_at_chain_node(node, node_subtree_weight,
+                                std::move(chain_sigs), node_has_child, comp_weight_bounds, pruning);
+                    }
+                    if (options.beam_width > 0 && cached_sigs_it == class_sigs.end()) {
+                        statistics.beam_dropped_cnt += truncate_to_beam(signatures[lvl_idx][node_idx], options.beam_width);
+                    }
+                    if (options.memoize_isomorphic) {
+                        size_t& remaining_cnt = remaining_class_cnt[node_class];
+                        remaining_cnt -= 1;
+                        if (remaining_cnt == 0) {
+                            class_sigs.erase(node_class);
+                        } else if (cached_sigs_it == class_sigs.end() && delete_signatures) {
+                            class_sigs[node_class] = std::make_shared<Tree::SignatureMap const>(
+                                    std::move(signatures[lvl_idx][node_idx]));
+                            shared_sigs[lvl_idx][node_idx] = class_sigs[node_class];
+                        } else if (cached_sigs_it == class_sigs.end()) {
+                            class_sigs[node_class] = std::make_shared<Tree::SignatureMap const>(signatures[lvl_idx][node_idx]);
+                        }
+                    }
 
                     // Delete unnecessary signatures after using them.
                     if (delete_signatures) {
                         if (node_has_left_sibling) {
-                            signatures[lvl_idx][node_idx - 1] = SignatureMap();
+                            signatures[lvl_idx][run_begin_idx - 1] = SignatureMap();
+                            if (!shared_sigs.empty()) {
+                                shared_sigs[lvl_idx][run_begin_idx - 1].reset();
+                            }
                         }
                         for (Id child_idx = node.children_idx_range.first;
                                 child_idx < node.children_idx_range.second; ++child_idx) { 
                             signatures[lvl_idx + 1][child_idx] = SignatureMap();
+                            if (!shared_sigs.empty()) {
+                                shared_sigs[lvl_idx + 1][static_cast<size_t>(child_idx)].reset();
+                            }
                         }
                     }
                 }
@@ -223,23 +709,28 @@ namespace cut {
             // Calculate the signatures at the root according to the paper FF13. 
             // Signatures which contain less then the total amount of nodes are ignored.
             NodeWeight const tree_weight = this->subtree_weight[0][0];
-            size_t const tree_weight_st = static_cast<size_t>(tree_weight);
             Tree::SignatureMap& root_sigs = signatures[0][0];
-            root_sigs = SignatureMap(tree_weight_st + 1);
-            Tree::SignatureMap& child_sigs = signatures.at(1).back();
+            root_sigs = SignatureMap();
+            Tree::SignatureMap const& child_sigs = sigs_at(1, signatures.at(1).size() - 1);
 
-            for (NodeWeight root_comp_weight_cnt = this->levels[0][0].weight; 
-                    root_comp_weight_cnt < comp_weight_bounds.back(); ++root_comp_weight_cnt) {
-                for (auto const& sig : child_sigs.at(static_cast<size_t>(tree_weight - root_comp_weight_cnt))) {
+            for (auto const& child_sigs_with_weight : child_sigs) {
+                NodeWeight const root_comp_weight = tree_weight - child_sigs_with_weight.first;
+                if (root_comp_weight >= comp_weight_bounds.back()) {
+                    continue;
+                }
+                size_t i = 0;
+                while(root_comp_weight >= comp_weight_bounds[i]) { ++i; }
+                for (auto const& sig : child_sigs_with_weight.second) {
                     Tree::Signature root_sig(sig.first);
-                    size_t i = 0;
-                    while(root_comp_weight_cnt >= comp_weight_bounds[i]) { ++i; }
                     root_sig[i] += 1;
+                    if (pruning.is_unpackable(root_sig)) {
+                        continue;
+                    }
 
-                    auto prev_cut_cost_it = root_sigs[tree_weight_st].find(root_sig);
-                    if (prev_cut_cost_it == root_sigs[tree_weight_st].end()
-                            || sig.second < prev_cut_cost_it->second) {
-                        root_sigs[tree_weight_st][root_sig] = sig.second;
+                    auto& full_root_sigs = root_sigs[tree_weight];
+                    auto prev_cut_cost_it = full_root_sigs.find(root_sig);
+                    if (prev_cut_cost_it == full_root_sigs.end() || sig.second < prev_cut_cost_it->second) {
+                        full_root_sigs[root_sig] = sig.second;
                     }
                 }
             }
@@ -248,6 +739,11 @@ namespace cut {
             if (delete_signatures) {
                 signatures[1].back() = SignatureMap();
             }
+            if (options.statistics != nullptr) {
+                statistics.cost_pruned_cnt = pruning.cost_pruned_cnt;
+                statistics.packing_pruned_cnt = pruning.packing_pruned_cnt;
+                *options.statistics = statistics;
+            }
             return SignaturesForTree<Id, NodeWeight, EdgeWeight>(part_cnt, eps, *this, std::move(signatures));
         }
 
@@ -438,6 +934,20 @@ namespace cut {
             return lower_comp_weight_bounds;
         }
 
+    template<typename NodeWeight>
+        Rational calculate_coarsened_imbalance(Rational eps, NodeWeight tree_weight, NodeWeight node_cnt,
+                NodeWeight part_cnt, NodeWeight granularity) {
+            // A part of the coarsened tree weighs at most (1 + eps') * ceil(W' / k) where the coarsened
+            // tree weight W' is less than W / g + n. Scaled back by g this is at most
+            // (1 + eps') * (W + g * (n + k)) / k, which must not exceed (1 + eps) * W / k.
+            Rational coarsened_eps = (Rational(1) + eps) * Rational(tree_weight)
+                / Rational(tree_weight + granularity * (node_cnt + part_cnt)) - Rational(1);
+            if (coarsened_eps <= 0) {
+                throw std::invalid_argument("The granularity of the node weights is too coarse for the imbalance.");
+            }
+            return coarsened_eps;
+        }
+
     template<typename Id, typename NodeWeight, typename EdgeWeight>
         typename SignaturesForTree<Id, NodeWeight, EdgeWeight>::CutEdges 
         SignaturesForTree<Id, NodeWeight, EdgeWeight>::cut_edges_for_signature(
@@ -56,11 +56,17 @@ namespace cut {
             return stream.str();
         }
 
-    template<typename Id, typename EdgeWeight>
-        std::istream& operator>>(std::istream& is, Tree<Id, int, EdgeWeight>& tree) {
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::istream& operator>>(std::istream& is, Tree<Id, NodeWeight, EdgeWeight>& tree) {
+            // The header line optionally indicates that node weights follow the edges.
+            std::string header;
+            is >> std::ws;
+            std::getline(is, header);
+            std::istringstream header_stream(header);
             Id node_cnt;
             Id root_id;
-            is >> node_cnt >> root_id;
+            int has_node_weights = 0;
+            header_stream >> node_cnt >> root_id >> has_node_weights;
 
             std::map<Id, std::map<Id, EdgeWeight>> tree_map;
             for (Id edge_idx = 0; edge_idx < node_cnt - 1; ++edge_idx) {
@@ -72,30 +78,50 @@ namespace cut {
                 tree_map[to][from] = weight;
             }
 
-            std::map<Id, int> node_weight;
+            std::map<Id, NodeWeight> node_weight;
             for (auto const& node : tree_map) {
                 node_weight[node.first] = 1;
             }
+            if (has_node_weights != 0) {
+                for (Id node_idx = 0; node_idx < node_cnt; ++node_idx) {
+                    Id node;
+                    NodeWeight weight;
+                    is >> node >> weight;
+                    node_weight[node] = weight;
+                }
+            }
 
-            tree = Tree<Id, EdgeWeight>::build_tree(tree_map, node_weight, root_id);
+            tree = Tree<Id, NodeWeight, EdgeWeight>::build_tree(tree_map, node_weight, root_id);
 
             return is;
         }
 
-    template<typename Id, typename EdgeWeight>
-        std::ostream& operator<<(std::ostream& os, Tree<Id, int, EdgeWeight> const& tree) {
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::ostream& operator<<(std::ostream& os, Tree<Id, NodeWeight, EdgeWeight> const& tree) {
             size_t node_cnt = 0;
+            bool has_node_weights = false;
             for (auto const& lvl: tree.levels) {
                 node_cnt += lvl.size();
+                for (auto const& node : lvl) {
+                    has_node_weights = has_node_weights || node.weight != 1;
+                }
             }
 
-            os << node_cnt << " " << tree.levels[0][0].id << std::endl;
+            os << node_cnt << " " << tree.levels[0][0].id;
+            os << (has_node_weights ? " 1" : "") << std::endl;
             for (size_t lvl_idx = 1; lvl_idx < tree.levels.size(); ++lvl_idx) {
                 for (auto const& node : tree.levels[lvl_idx]) {
                     os << tree.levels[lvl_idx - 1][node.parent_idx].id << " ";
                     os << node.id << " " << node.parent_edge_weight << std::endl;
                 }
             }
+            if (has_node_weights) {
+                for (auto const& lvl : tree.levels) {
+                    for (auto const& node : lvl) {
+                        os << node.id << " " << node.weight << std::endl;
+                    }
+                }
+            }
             return os;
         }
 
@@ -115,17 +141,15 @@ namespace cut {
                     os << signatures.tree.levels[lvl_idx][node_idx].id << " ";
                     os << node_sigs.size() << std::endl;
 
-                    Id node_sigs_weight = 0;
                     for (auto const& node_sigs_with_weight : node_sigs) {
-                        os << node_sigs_weight << " ";
-                        os << node_sigs_with_weight.size() << std::endl;
-                        for (auto const& sig : node_sigs_with_weight) {
+                        os << node_sigs_with_weight.first << " ";
+                        os << node_sigs_with_weight.second.size() << std::endl;
+                        for (auto const& sig : node_sigs_with_weight.second) {
                             for (auto const& val : sig.first) {
                                 os << val << " ";
                             }
                             os << sig.second << std::endl;
                         }
-                        node_sigs_weight += 1;
                     }
                     os << std::endl;
                 }
@@ -191,13 +215,8 @@ namespace cut {
                 is >> node_id >> weight_cnt;
                 auto node_idx_in_tree = builder.tree.get_node_idx(node_id);
 
-                NodeWeight max_sig_weight = 1;
-                for (size_t sibling_idx = 0; sibling_idx <= node_idx_in_tree.second; ++sibling_idx) {
-                    max_sig_weight += builder.tree.subtree_weight[node_idx_in_tree.first][sibling_idx];
-                }
-
                 SignatureMap<NodeWeight, EdgeWeight>& node_sigs = signatures[node_idx_in_tree.first][node_idx_in_tree.second];
-                node_sigs = SignatureMap<NodeWeight, EdgeWeight>(static_cast<size_t>(max_sig_weight));
+                node_sigs = SignatureMap<NodeWeight, EdgeWeight>();
 
                 for (NodeWeight weight_idx = 0; weight_idx < weight_cnt; ++weight_idx) {
                     NodeWeight weight;
@@ -211,7 +230,7 @@ namespace cut {
                             is >> comp;
                         }
                         is >> cut_cost;
-                        node_sigs.at(weight)[signature] = cut_cost;
+                        node_sigs[weight][signature] = cut_cost;
                     }
                 }
             }
@@ -219,4 +238,347 @@ namespace cut {
 
             return is;
         }
+
+    /**
+     * Writes a value of a signature table chunk.
+     * @param os The outputstream.
+     * @param value The value.
+     * @param is_compressed Indicates whether the value is written as variable length integer.
+     */
+    inline void write_signature_table_value(std::ostream& os, int64_t value, bool is_compressed) {
+        if (is_compressed) {
+            fileutils::write_varint(os, fileutils::zigzag_encode(value));
+        } else {
+            os.write(reinterpret_cast<char const*>(&value), sizeof(value));
+        }
+    }
+
+    /**
+     * Reads a value of a signature table chunk.
+     * @param pos The position to read from. It is moved past the value.
+     * @param end The end of the chunk.
+     * @param is_compressed Indicates whether the value is stored as variable length integer.
+     * @returns The value.
+     */
+    inline int64_t read_signature_table_value(char const*& pos, char const* end, bool is_compressed) {
+        if (is_compressed) {
+            return fileutils::zigzag_decode(fileutils::read_varint(pos, end));
+        } else {
+            int64_t value;
+            if (static_cast<size_t>(end - pos) < sizeof(value)) {
+                throw std::runtime_error("Truncated signature table chunk.");
+            }
+            std::memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return value;
+        }
+    }
+
+    /**
+     * Decodes the chunk of a node in a signature table.
+     * @param begin The start of the chunk after its size.
+     * @param end The end of the chunk.
+     * @param is_compressed Indicates whether the values are compressed.
+     * @param signature_length The length of a signature.
+     * @param node_id Is set to the id of the node.
+     * @returns The signatures at the node.
+     */
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        SignatureMap<NodeWeight, EdgeWeight> decode_signature_table_chunk(
+                char const* begin, char const* end, bool is_compressed, size_t signature_length, Id& node_id) {
+            char const* pos = begin;
+            auto read_value = [&pos, end, is_compressed](){
+                return read_signature_table_value(pos, end, is_compressed);
+            };
+
+            node_id = static_cast<Id>(read_value());
+            // The number of lower frontier weights is not needed since only the non-empty ones are stored.
+            read_value();
+            SignatureMap<NodeWeight, EdgeWeight> node_sigs;
+            int64_t const bucket_cnt = read_value();
+            for (int64_t bucket_idx = 0; bucket_idx < bucket_cnt; ++bucket_idx) {
+                NodeWeight const weight = static_cast<NodeWeight>(read_value());
+                int64_t const signature_cnt = read_value();
+                auto& node_sigs_with_weight = node_sigs[weight];
+                node_sigs_with_weight.reserve(static_cast<size_t>(signature_cnt));
+
+                Signature<NodeWeight> signature(signature_length);
+                for (int64_t signature_idx = 0; signature_idx < signature_cnt; ++signature_idx) {
+                    for (auto& comp : signature) {
+                        comp = is_compressed ? 
+                            static_cast<NodeWeight>(comp + read_value()) : static_cast<NodeWeight>(read_value());
+                    }
+                    node_sigs_with_weight[signature] = static_cast<EdgeWeight>(read_value());
+                }
+            }
+            return node_sigs;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        SignatureTableFile<Id, NodeWeight, EdgeWeight>::SignatureTableFile(std::string const& filename) :
+            file(std::make_shared<fileutils::MappedFile>(filename)) {
+
+            char const* const begin = this->file->begin();
+            char const* const end = this->file->end();
+            size_t const trailer_size = sizeof(uint64_t) + sizeof(SIGNATURE_INDEX_MAGIC);
+            if (this->file->size() < sizeof(SignatureTableHeader) + trailer_size ||
+                    !std::equal(SIGNATURE_TABLE_MAGIC, SIGNATURE_TABLE_MAGIC + 8, begin) ||
+                    !std::equal(SIGNATURE_INDEX_MAGIC, SIGNATURE_INDEX_MAGIC + 8, end - sizeof(SIGNATURE_INDEX_MAGIC))) {
+                throw std::runtime_error(filename + " is not a signature table.");
+            }
+            std::memcpy(&this->header, begin, sizeof(SignatureTableHeader));
+            if (this->header.version != SIGNATURE_TABLE_VERSION ||
+                    this->header.id_size != sizeof(Id) ||
+                    this->header.node_weight_size != sizeof(NodeWeight) ||
+                    this->header.edge_weight_size != sizeof(EdgeWeight)) {
+                throw std::runtime_error("The signature table " + filename + " has a different version or types.");
+            }
+            char const* const eps_begin = begin + sizeof(SignatureTableHeader);
+            if (this->header.eps_size > static_cast<uint64_t>(end - eps_begin)) {
+                throw std::runtime_error("The signature table " + filename + " is truncated.");
+            }
+            this->stored_eps = Rational(std::string(eps_begin, eps_begin + this->header.eps_size));
+
+            uint64_t index_offset;
+            std::memcpy(&index_offset, end - trailer_size, sizeof(index_offset));
+            uint64_t const index_entry_size = sizeof(int64_t) + sizeof(uint64_t);
+            if (index_offset > this->file->size() - trailer_size ||
+                    (this->file->size() - trailer_size - index_offset) / index_entry_size != this->header.node_cnt) {
+                throw std::runtime_error("The index of the signature table " + filename + " is corrupt.");
+            }
+            char const* index_pos = begin + index_offset;
+            for (uint64_t node_pos = 0; node_pos < this->header.node_cnt; ++node_pos) {
+                int64_t node_id;
+                uint64_t chunk_offset;
+                std::memcpy(&node_id, index_pos, sizeof(node_id));
+                std::memcpy(&chunk_offset, index_pos + sizeof(node_id), sizeof(chunk_offset));
+                index_pos += index_entry_size;
+                if (chunk_offset + sizeof(uint64_t) > index_offset) {
+                    throw std::runtime_error("The index of the signature table " + filename + " is corrupt.");
+                }
+                this->node_ids.push_back(static_cast<Id>(node_id));
+                this->chunk_offsets.push_back(chunk_offset);
+            }
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        typename SignatureTableFile<Id, NodeWeight, EdgeWeight>::SignatureMap
+        SignatureTableFile<Id, NodeWeight, EdgeWeight>::read_node_signatures(size_t node_pos) const {
+            char const* const chunk = this->file->begin() + this->chunk_offsets.at(node_pos);
+            uint64_t chunk_size;
+            std::memcpy(&chunk_size, chunk, sizeof(chunk_size));
+            char const* const chunk_begin = chunk + sizeof(chunk_size);
+            if (chunk_size > static_cast<uint64_t>(this->file->end() - chunk_begin)) {
+                throw std::runtime_error("Truncated signature table chunk.");
+            }
+
+            Id node_id;
+            auto node_sigs = decode_signature_table_chunk<Id, NodeWeight, EdgeWeight>(
+                    chunk_begin, chunk_begin + chunk_size, this->header.is_compressed != 0,
+                    this->signature_length(), node_id);
+            if (node_id != this->node_ids[node_pos]) {
+                throw std::runtime_error("The index of the signature table does not match the chunks.");
+            }
+            return node_sigs;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        SignaturesForTree<Id, NodeWeight, EdgeWeight>::SignaturesForTree(
+                Tree const& tree, std::shared_ptr<SignatureTableFile<Id, NodeWeight, EdgeWeight> const> table_file) :
+            SignaturesForTree(table_file->part_cnt(), table_file->eps(), tree, [&tree](){
+                    std::vector<std::vector<SignatureMap>> signatures;
+                    for (auto const& lvl : tree.levels) {
+                        signatures.emplace_back(lvl.size());
+                    }
+                    return signatures;
+                    }()) {
+
+            size_t node_pos = 0;
+            for (auto const& lvl : tree.levels) {
+                for (auto const& node : lvl) {
+                    if (node_pos >= table_file->node_cnt() || table_file->node_id(node_pos) != node.id) {
+                        throw std::invalid_argument("The signature table does not belong to the tree.");
+                    }
+                    ++node_pos;
+                }
+            }
+            if (node_pos != table_file->node_cnt() || 
+                    table_file->signature_length() != this->upper_comp_weight_bounds.size()) {
+                throw std::invalid_argument("The signature table does not belong to the tree.");
+            }
+            this->table_file = table_file;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        typename SignaturesForTree<Id, NodeWeight, EdgeWeight>::SignatureMap const&
+        SignaturesForTree<Id, NodeWeight, EdgeWeight>::node_signatures(size_t lvl_idx, size_t node_idx) const {
+            if (!this->table_file) {
+                return this->signatures.at(lvl_idx).at(node_idx);
+            }
+
+            auto const node_idx_pair = std::make_pair(lvl_idx, node_idx);
+            auto loaded_sigs = this->loaded_signatures.find(node_idx_pair);
+            if (loaded_sigs == this->loaded_signatures.end()) {
+                size_t node_pos = node_idx;
+                for (size_t prev_lvl_idx = 0; prev_lvl_idx < lvl_idx; ++prev_lvl_idx) {
+                    node_pos += this->tree.levels[prev_lvl_idx].size();
+                }
+                loaded_sigs = this->loaded_signatures.emplace(
+                        node_idx_pair, this->table_file->read_node_signatures(node_pos)).first;
+            }
+            return loaded_sigs->second;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::ostream& operator<<(std::ostream& os, WriteSignatureTable<Id, NodeWeight, EdgeWeight> const& write) {
+            auto const& signatures = write.signatures;
+            auto const& tree = signatures.tree;
+            bool const is_compressed = write.do_compress;
+
+            std::string const eps_string = signatures.eps.get_str();
+            size_t node_cnt = 0;
+            for (auto const& lvl : tree.levels) {
+                node_cnt += lvl.size();
+            }
+
+            SignatureTableHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::copy(SIGNATURE_TABLE_MAGIC, SIGNATURE_TABLE_MAGIC + 8, header.magic);
+            header.version = SIGNATURE_TABLE_VERSION;
+            header.is_compressed = is_compressed ? 1 : 0;
+            header.id_size = sizeof(Id);
+            header.node_weight_size = sizeof(NodeWeight);
+            header.edge_weight_size = sizeof(EdgeWeight);
+            header.signature_length = static_cast<uint32_t>(signatures.upper_comp_weight_bounds.size());
+            header.node_cnt = node_cnt;
+            header.part_cnt = static_cast<int64_t>(signatures.part_cnt);
+            header.eps_size = eps_string.size();
+
+            uint64_t offset = 0;
+            os.write(reinterpret_cast<char const*>(&header), sizeof(header));
+            os.write(eps_string.data(), static_cast<std::streamsize>(eps_string.size()));
+            offset += sizeof(header) + eps_string.size();
+            while (offset % 8 != 0) {
+                os.put('\0');
+                ++offset;
+            }
+
+            auto compare_signatures = [](Signature<NodeWeight> const* left, Signature<NodeWeight> const* right) {
+                return std::lexicographical_compare(std::begin(*left), std::end(*left), std::begin(*right), std::end(*right));
+            };
+
+            std::vector<std::pair<int64_t, uint64_t>> index;
+            for (size_t lvl_idx = 0; lvl_idx < tree.levels.size(); ++lvl_idx) {
+                for (size_t node_idx = 0; node_idx < tree.levels[lvl_idx].size(); ++node_idx) {
+                    auto const& node_sigs = signatures.node_signatures(lvl_idx, node_idx);
+                    std::ostringstream chunk;
+                    auto write_value = [&chunk, is_compressed](int64_t value) {
+                        write_signature_table_value(chunk, value, is_compressed);
+                    };
+
+                    write_value(static_cast<int64_t>(tree.levels[lvl_idx][node_idx].id));
+                    write_value(node_sigs.empty() ? 0 : static_cast<int64_t>(node_sigs.rbegin()->first) + 1);
+                    int64_t bucket_cnt = 0;
+                    for (auto const& node_sigs_with_weight : node_sigs) {
+                        bucket_cnt += node_sigs_with_weight.second.empty() ? 0 : 1;
+                    }
+                    write_value(bucket_cnt);
+
+                    for (auto const& weight_and_sigs : node_sigs) {
+                        auto const& node_sigs_with_weight = weight_and_sigs.second;
+                        if (node_sigs_with_weight.empty()) {
+                            continue;
+                        }
+                        write_value(static_cast<int64_t>(weight_and_sigs.first));
+                        write_value(static_cast<int64_t>(node_sigs_with_weight.size()));
+
+                        // Sort the signatures such that the differences between consecutive signatures are small.
+                        std::vector<Signature<NodeWeight> const*> sorted_sigs;
+                        for (auto const& sig : node_sigs_with_weight) {
+                            sorted_sigs.push_back(&sig.first);
+                        }
+                        std::sort(sorted_sigs.begin(), sorted_sigs.end(), compare_signatures);
+
+                        Signature<NodeWeight> prev_sig(header.signature_length);
+                        for (auto const sig : sorted_sigs) {
+                            for (size_t comp_idx = 0; comp_idx < sig->size(); ++comp_idx) {
+                                write_value(is_compressed ? 
+                                        static_cast<int64_t>((*sig)[comp_idx]) - static_cast<int64_t>(prev_sig[comp_idx]) :
+                                        static_cast<int64_t>((*sig)[comp_idx]));
+                            }
+                            write_value(static_cast<int64_t>(node_sigs_with_weight.at(*sig)));
+                            prev_sig = *sig;
+                        }
+                    }
+
+                    std::string const chunk_data = chunk.str();
+                    uint64_t const chunk_size = chunk_data.size();
+                    index.emplace_back(static_cast<int64_t>(tree.levels[lvl_idx][node_idx].id), offset);
+                    os.write(reinterpret_cast<char const*>(&chunk_size), sizeof(chunk_size));
+                    os.write(chunk_data.data(), static_cast<std::streamsize>(chunk_size));
+                    offset += sizeof(chunk_size) + chunk_size;
+                }
+            }
+
+            uint64_t const index_offset = offset;
+            for (auto const& entry : index) {
+                os.write(reinterpret_cast<char const*>(&entry.first), sizeof(entry.first));
+                os.write(reinterpret_cast<char const*>(&entry.second), sizeof(entry.second));
+            }
+            os.write(reinterpret_cast<char const*>(&index_offset), sizeof(index_offset));
+            os.write(SIGNATURE_INDEX_MAGIC, sizeof(SIGNATURE_INDEX_MAGIC));
+            return os;
+        }
+
+    template<typename Id, typename NodeWeight, typename EdgeWeight>
+        std::istream& operator>>(std::istream& is, ReadSignatureTable<Id, NodeWeight, EdgeWeight>& read) {
+            auto& builder = read.builder;
+
+            SignatureTableHeader header;
+            if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                    !std::equal(SIGNATURE_TABLE_MAGIC, SIGNATURE_TABLE_MAGIC + 8, header.magic)) {
+                throw std::runtime_error("Not a signature table.");
+            }
+            if (header.version != SIGNATURE_TABLE_VERSION ||
+                    header.id_size != sizeof(Id) ||
+                    header.node_weight_size != sizeof(NodeWeight) ||
+                    header.edge_weight_size != sizeof(EdgeWeight)) {
+                throw std::runtime_error("The signature table has a different version or types.");
+            }
+            std::string eps_string(static_cast<size_t>((sizeof(header) + header.eps_size + 7) / 8 * 8 - sizeof(header)), '\0');
+            is.read(&eps_string[0], static_cast<std::streamsize>(eps_string.size()));
+            eps_string.resize(static_cast<size_t>(header.eps_size));
+            builder.with_part_cnt(static_cast<NodeWeight>(header.part_cnt)).with_eps(Rational(eps_string));
+
+            std::vector<std::vector<SignatureMap<NodeWeight, EdgeWeight>>> signatures;
+            for (auto const& lvl : builder.tree.levels) {
+                signatures.emplace_back(lvl.size());
+            }
+
+            std::string chunk;
+            for (uint64_t node_pos = 0; node_pos < header.node_cnt; ++node_pos) {
+                uint64_t chunk_size;
+                is.read(reinterpret_cast<char*>(&chunk_size), sizeof(chunk_size));
+                chunk.resize(static_cast<size_t>(chunk_size));
+                if (!is || !is.read(&chunk[0], static_cast<std::streamsize>(chunk_size))) {
+                    throw std::runtime_error("Truncated signature table chunk.");
+                }
+
+                Id node_id;
+                auto node_sigs = decode_signature_table_chunk<Id, NodeWeight, EdgeWeight>(
+                        chunk.data(), chunk.data() + chunk.size(), header.is_compressed != 0,
+                        header.signature_length, node_id);
+                auto node_idx_in_tree = builder.tree.get_node_idx(node_id);
+                if (node_idx_in_tree.first >= signatures.size()) {
+                    throw std::runtime_error("The signature table does not belong to the tree.");
+                }
+                signatures[node_idx_in_tree.first][node_idx_in_tree.second] = std::move(node_sigs);
+            }
+
+            // Skip the index and the trailer.
+            is.ignore(static_cast<std::streamsize>(header.node_cnt * (sizeof(int64_t) + sizeof(uint64_t)) +
+                        sizeof(uint64_t) + sizeof(SIGNATURE_INDEX_MAGIC)));
+            builder.with_signatures(signatures);
+            return is;
+        }
 }
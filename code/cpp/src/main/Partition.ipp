@@ -19,9 +19,13 @@ template<typename Id, typename NodeWeight, typename EdgeWeight>
 
         std::priority_queue<SignatureWithCost, std::vector<SignatureWithCost>, decltype(compare)> prio_q(compare);
 
-        auto const& root_sigs = signatures.signatures[0][0].back();
-        for (auto const& sig : root_sigs) {
-            prio_q.emplace(sig.second, sig.first);
+        // Only the signatures at the root which contain all nodes of the tree are complete.
+        auto const& root_sigs = signatures.node_signatures(0, 0);
+        auto const full_root_sigs = root_sigs.find(signatures.tree.subtree_weight[0][0]);
+        if (full_root_sigs != root_sigs.end()) {
+            for (auto const& sig : full_root_sigs->second) {
+                prio_q.emplace(sig.second, sig.first);
+            }
         }
 
         while (!prio_q.empty()) {
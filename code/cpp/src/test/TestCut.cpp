@@ -1,6 +1,8 @@
 #include<cstdint>
+#include<cstdio>
 #include<fstream>
 #include<iostream>
+#include<memory>
 #include<set>
 #include<string>
 
@@ -34,9 +36,9 @@ TEST_P(TestCut, CutsAsExpected) {
             auto const& node_sigs = signatures.signatures[lvl_idx][node_idx];
             EXPECT_EQ(should_node_sigs.size(), node_sigs.size());
 
-            int node_sigs_size = 0;
-            for (auto const& should_node_sigs_with_size : should_node_sigs) {
-                auto const& node_sigs_with_size = node_sigs.at(static_cast<size_t>(node_sigs_size));
+            for (auto const& should_node_sigs_with_weight : should_node_sigs) {
+                auto const& should_node_sigs_with_size = should_node_sigs_with_weight.second;
+                auto const& node_sigs_with_size = node_sigs.at(should_node_sigs_with_weight.first);
                 EXPECT_EQ(should_node_sigs_with_size.size(), node_sigs_with_size.size());
                 for (auto const& should_node_sig : should_node_sigs_with_size) {
                     EXPECT_NE(
@@ -45,12 +47,62 @@ TEST_P(TestCut, CutsAsExpected) {
                             );
                     EXPECT_EQ(should_node_sig.second, node_sigs_with_size.at(should_node_sig.first));
                 }
-                ++node_sigs_size;
             }
         }
     }
 }
 
+TEST_P(TestCut, RoundTripsSignatureTable) {
+    using Id = int32_t;
+    using EdgeWeight = int32_t;
+    using Tree = cut::Tree<Id, EdgeWeight>;
+    using SignatureTableFile = cut::SignatureTableFile<Id, int, EdgeWeight>;
+
+    std::string tree_name = this->GetParam().first;
+    std::string params_name = this->GetParam().second;
+
+    auto params = testutils::get_algorithm_params<int>(tree_name, params_name);
+    Tree tree = testutils::get_tree<Id, EdgeWeight>(tree_name);
+    auto signatures = tree.cut(params.eps, params.part_cnt);
+
+    for (bool do_compress : {false, true}) {
+        std::string const file_name = "signatures_" + tree_name + "_" + params_name + ".sigtable";
+        {
+            std::ofstream file(file_name, std::ios::binary);
+            file << cut::WriteSignatureTable<Id, int, EdgeWeight>(signatures, do_compress);
+        }
+
+        cut::SignaturesForTreeBuilder<Id, int, EdgeWeight> builder(tree);
+        cut::ReadSignatureTable<Id, int, EdgeWeight> read(builder);
+        std::ifstream file(file_name, std::ios::binary);
+        file >> read;
+        auto streamed_signatures = builder.finish();
+
+        cut::SignaturesForTree<Id, int, EdgeWeight> lazy_signatures(
+                tree, std::make_shared<SignatureTableFile const>(file_name));
+        ASSERT_EQ(signatures.part_cnt, lazy_signatures.part_cnt);
+        ASSERT_EQ(signatures.eps, lazy_signatures.eps);
+        for (size_t lvl_idx = 0; lvl_idx < signatures.signatures.size(); ++lvl_idx) {
+            for (size_t node_idx = 0; node_idx < signatures.signatures[lvl_idx].size(); ++node_idx) {
+                auto const& node_sigs = signatures.signatures[lvl_idx][node_idx];
+                for (auto const& read_node_sigs : {
+                        lazy_signatures.node_signatures(lvl_idx, node_idx),
+                        streamed_signatures.signatures[lvl_idx][node_idx]}) {
+                    ASSERT_EQ(node_sigs.size(), read_node_sigs.size());
+                    for (auto const& node_sigs_with_weight : node_sigs) {
+                        auto const& read_node_sigs_with_weight = read_node_sigs.at(node_sigs_with_weight.first);
+                        ASSERT_EQ(node_sigs_with_weight.second.size(), read_node_sigs_with_weight.size());
+                        for (auto const& sig : node_sigs_with_weight.second) {
+                            ASSERT_EQ(sig.second, read_node_sigs_with_weight.at(sig.first));
+                        }
+                    }
+                }
+            }
+        }
+        std::remove(file_name.c_str());
+    }
+}
+
 INSTANTIATE_TEST_CASE_P(
         CutTests,
         TestCut,
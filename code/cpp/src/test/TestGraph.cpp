@@ -1,18 +1,67 @@
 #include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstddef>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
 #include<iostream>
+#include<limits>
 #include<memory>
+#include<set>
 #include<sstream>
 #include<stdexcept>
 #include<string>
+#include<thread>
+#include<tuple>
 
 #include<gtest/gtest.h>
 #include<metis.h>
+#include<sys/stat.h>
 
 #include "Graph.hpp"
 #include "GraphIo.hpp"
 #include "GraphUtils.hpp"
 #include "GraphGen.hpp"
 #include "GMPUtils.hpp"
+#include "Pipeline.hpp"
+#include "SnapConvert.hpp"
+
+// Checks if two signature maps contain the same signatures with the same cut costs for each frontier weight.
+template<typename SignatureMap>
+bool equal_signatures(SignatureMap const& lhs, SignatureMap const& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (auto const& sigs_with_weight : lhs) {
+        auto const rhs_sigs_it = rhs.find(sigs_with_weight.first);
+        if (rhs_sigs_it == rhs.cend() || rhs_sigs_it->second.size() != sigs_with_weight.second.size()) {
+            return false;
+        }
+        for (auto const& sig : sigs_with_weight.second) {
+            auto const rhs_sig_it = rhs_sigs_it->second.find(sig.first);
+            if (rhs_sig_it == rhs_sigs_it->second.cend() || rhs_sig_it->second != sig.second) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Checks if a part of the partition is heavier than the imbalance allows for the node weights of the graph.
+bool violates_balance(graph::Graph<> const& graph, std::vector<int32_t> const& partition, int32_t kparts,
+        graph::Rational imbalance) {
+    std::vector<int32_t> part_weight(static_cast<size_t>(kparts), 0);
+    int32_t total_weight = 0;
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        part_weight.at(static_cast<size_t>(partition.at(static_cast<size_t>(node)))) += graph.node_weight(node);
+        total_weight += graph.node_weight(node);
+    }
+
+    int32_t const max_weight = graph::max_part_weight(total_weight, kparts, imbalance);
+    return std::any_of(part_weight.cbegin(), part_weight.cend(),
+            [max_weight](int32_t const weight){ return weight > max_weight; });
+}
 
 TEST(Graph, EmptyInput) {
     graph::Graph<> graph;
@@ -85,6 +134,416 @@ TEST(Graph, TwoNodes) {
     ASSERT_EQ(graph.node_weight(1), 1);
 }
 
+TEST(Graph, OneSidedAndDuplicateEdges) {
+    graph::Graph<> graph;
+    std::stringstream graph_stream("% comment\n\n4 3 001\n1 5 3 1\n% comment\n\n0 7 1 9 1 4\n0 2\n");
+    graph_stream >> graph;
+    ASSERT_EQ(graph.node_cnt(), 4);
+    ASSERT_EQ(graph.edge_cnt(), 4);
+    ASSERT_EQ(graph.edge_weight(0, 1), 5);
+    ASSERT_EQ(graph.edge_weight(0, 3), 2);
+    ASSERT_EQ(graph.edge_weight(3, 0), 2);
+    ASSERT_EQ(graph.edge_weight(2, 0), 7);
+    ASSERT_EQ(graph.edge_weight(2, 1), 4);
+    ASSERT_EQ(graph.adj_nodes(1).size(), 2);
+}
+
+TEST(Graph, ReportsFirstError) {
+    graph::Graph<> graph;
+    std::stringstream graph_stream("3 2 011\n1 1\n\n1 7\n");
+    try {
+        graph_stream >> graph;
+        FAIL();
+    } catch (std::invalid_argument const& error) {
+        ASSERT_EQ(std::string(error.what()), "Edge weight missing at edge from 0 to 1.");
+    }
+
+    graph_stream.str("2 1 001\n1 1\n2 1\n");
+    graph_stream.clear();
+    ASSERT_THROW(graph_stream >> graph, std::out_of_range);
+}
+
+TEST(Graph, ReadFileLikeStream) {
+    std::string const file_name = "resources/data_sets/email-Eu-core/email-Eu-core.graph";
+    graph::Graph<> mapped_graph;
+    graphio::read_metis_file(file_name, mapped_graph, 4);
+
+    graph::Graph<> stream_graph;
+    std::ifstream file(file_name);
+    file >> stream_graph;
+
+    ASSERT_EQ(mapped_graph.node_cnt(), 1005);
+    ASSERT_EQ(mapped_graph.node_cnt(), stream_graph.node_cnt());
+    for (int32_t node = 0; node < mapped_graph.node_cnt(); ++node) {
+        ASSERT_EQ(mapped_graph.node_weight(node), stream_graph.node_weight(node));
+        auto mapped_edges = mapped_graph.inc_edges(node);
+        auto stream_edges = stream_graph.inc_edges(node);
+        std::sort(mapped_edges.begin(), mapped_edges.end());
+        std::sort(stream_edges.begin(), stream_edges.end());
+        ASSERT_EQ(mapped_edges, stream_edges);
+    }
+}
+
+TEST(Graph, BinaryFormatRoundTrip) {
+    graph::Graph<> graph;
+    std::stringstream text_stream("3 3 011\n1 1 1 2 2\n2 0 1 2 3\n2 0 2 1 3\n");
+    text_stream >> graph;
+    graph.contract_edges(graph::Graph<>::Matching({std::make_pair(0, 1)}));
+
+    std::stringstream binary_stream;
+    binary_stream << graphio::WriteBinaryFormat<>(graph) << graphio::WriteBinaryFormat<>(graph);
+    std::string const binary = binary_stream.str();
+    ASSERT_TRUE(graphio::is_binary_graph(binary.data(), binary.data() + binary.size()));
+
+    graph::Graph<> stream_graph;
+    graphio::read_graph(binary_stream, stream_graph);
+    graph::Graph<> buffer_graph;
+    char const* pos = graphio::parse_graph(binary.data(), binary.data() + binary.size(), buffer_graph);
+    pos = graphio::parse_graph(pos, binary.data() + binary.size(), buffer_graph);
+    ASSERT_EQ(pos, binary.data() + binary.size());
+
+    for (auto const& read_graph : {stream_graph, buffer_graph}) {
+        ASSERT_EQ(read_graph.node_cnt(), 2);
+        ASSERT_EQ(read_graph.node_weight(0), 3);
+        ASSERT_EQ(read_graph.edge_weight(0, 1), 5);
+        ASSERT_EQ(read_graph.node_repr(0), graph::Graph<>::NodeSet({0, 1}));
+        ASSERT_EQ(read_graph.node_repr(1), graph::Graph<>::NodeSet({2}));
+    }
+
+    std::stringstream text_again;
+    text_again << stream_graph;
+    graph::Graph<> text_graph;
+    text_again >> text_graph;
+    ASSERT_EQ(text_graph.edge_weight(0, 1), 5);
+
+    std::string truncated = binary.substr(0, binary.size() / 2 - 8);
+    ASSERT_THROW(
+            graphio::parse_graph(truncated.data(), truncated.data() + truncated.size(), buffer_graph),
+            std::invalid_argument);
+
+    // Offsets which point past adjncy are rejected, even if the last offset is consistent.
+    std::string corrupt_xadj = binary;
+    uint64_t const past_adjncy = std::numeric_limits<uint32_t>::max();
+    std::memcpy(&corrupt_xadj[sizeof(graphio::BinaryGraphHeader) + sizeof(uint64_t)],
+            &past_adjncy, sizeof(uint64_t));
+    ASSERT_THROW(
+            graphio::parse_graph(corrupt_xadj.data(), corrupt_xadj.data() + corrupt_xadj.size(), buffer_graph),
+            std::invalid_argument);
+
+    std::string corrupt_node_cnt = binary;
+    uint64_t const huge_node_cnt = std::numeric_limits<uint64_t>::max() / 4;
+    std::memcpy(&corrupt_node_cnt[offsetof(graphio::BinaryGraphHeader, node_cnt)],
+            &huge_node_cnt, sizeof(uint64_t));
+    ASSERT_THROW(
+            graphio::parse_graph(corrupt_node_cnt.data(), corrupt_node_cnt.data() + corrupt_node_cnt.size(),
+                buffer_graph),
+            std::invalid_argument);
+}
+
+TEST(Graph, ConvertSnapExternally) {
+    std::stringstream snap_stream("# comment\n4 5\n10 7\n7 10\n\n3 3\n10 3\n3 10\n7 3\n");
+    graphio::SnapConvertOptions options;
+    std::stringstream text_stream;
+    auto stats = graphio::convert_snap_format<>(snap_stream, text_stream, options);
+    ASSERT_EQ(stats.input_edge_cnt, 6);
+    ASSERT_EQ(stats.node_cnt, 3);
+    ASSERT_EQ(stats.edge_cnt, 4);
+    ASSERT_EQ(text_stream.str(), "3 4 011\n1 0 1 1 1 2 1\n1 0 1 2 1\n1 0 1 1 1\n");
+
+    // A tiny memory budget forces many sorted runs.
+    std::string const file_name = "resources/data_sets/email-Eu-core/email-Eu-core.txt";
+    std::ifstream snap_file(file_name);
+    graph::Graph<> graph;
+    graphio::ReadSnapFormat<> read(graph);
+    snap_file >> read;
+
+    snap_file.clear();
+    snap_file.seekg(0);
+    options.memory_budget = 1 << 14;
+    options.is_binary = true;
+    std::stringstream binary_stream;
+    stats = graphio::convert_snap_format<>(snap_file, binary_stream, options);
+    ASSERT_GT(stats.run_cnt, 2);
+    graph::Graph<> converted_graph;
+    graphio::read_graph(binary_stream, converted_graph);
+
+    ASSERT_EQ(converted_graph.node_cnt(), graph.node_cnt());
+    ASSERT_EQ(converted_graph.edge_cnt(), graph.edge_cnt());
+    std::multiset<size_t> degrees;
+    std::multiset<size_t> converted_degrees;
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        degrees.insert(graph.inc_edges(node).size());
+        converted_degrees.insert(converted_graph.inc_edges(node).size());
+    }
+    ASSERT_EQ(degrees, converted_degrees);
+}
+
+TEST(Graph, DecompositionTree) {
+    std::ifstream snap_file("resources/data_sets/email-Eu-core/email-Eu-core.txt");
+    graph::Graph<> graph = graphio::read_snap_graph<>(snap_file);
+    graph::Graph<> tree = graph::decomposition_tree(graph, graph::Rational(1, 10), 4);
+    ASSERT_EQ(tree.node_cnt(), 2 * graph.node_cnt() - 1);
+    ASSERT_EQ(tree.edge_cnt(), tree.node_cnt() - 1);
+    ASSERT_TRUE(tree.is_tree());
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        ASSERT_EQ(tree.node_weight(node), graph.node_weight(node));
+        auto const leaf_edges = tree.inc_edges(node);
+        ASSERT_EQ(leaf_edges.size(), 1);
+        int32_t degree = 0;
+        for (auto const& edge : graph.inc_edges(node)) {
+            degree += (edge.first != node) ? edge.second : 0;
+        }
+        ASSERT_EQ(leaf_edges.begin()->second, degree);
+    }
+    for (int32_t node = graph.node_cnt(); node < tree.node_cnt(); ++node) {
+        ASSERT_EQ(tree.node_weight(node), 0);
+    }
+
+    // The ids of the clusters do not depend on the number of threads.
+    graph::Graph<> serial_tree = graph::decomposition_tree(graph, graph::Rational(1, 10), 1);
+    for (int32_t node = 0; node < tree.node_cnt(); ++node) {
+        auto const inc_edges = tree.inc_edges(node);
+        auto const serial_inc_edges = serial_tree.inc_edges(node);
+        std::set<std::pair<int32_t, int32_t>> const edges(inc_edges.begin(), inc_edges.end());
+        std::set<std::pair<int32_t, int32_t>> const serial_edges(serial_inc_edges.begin(), serial_inc_edges.end());
+        ASSERT_EQ(edges, serial_edges);
+    }
+}
+
+TEST(Graph, FrtTree) {
+    std::ifstream snap_file("resources/data_sets/email-Eu-core/email-Eu-core.txt");
+    graph::Graph<> graph = graphio::read_snap_graph<>(snap_file);
+    graph::Graph<> tree = graph::frt_tree(graph, 3, 4);
+    ASSERT_TRUE(tree.is_tree());
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        ASSERT_EQ(tree.node_weight(node), graph.node_weight(node));
+        ASSERT_EQ(tree.adj_nodes(node).size(), 1);
+    }
+    // Clusters with a single child are left out.
+    for (int32_t node = graph.node_cnt() + 1; node < tree.node_cnt(); ++node) {
+        ASSERT_EQ(tree.node_weight(node), 0);
+        ASSERT_GE(tree.adj_nodes(node).size(), 3);
+    }
+
+    graph::Graph<> serial_tree = graph::frt_tree(graph, 3, 1);
+    ASSERT_EQ(serial_tree.node_cnt(), tree.node_cnt());
+    for (int32_t node = 0; node < tree.node_cnt(); ++node) {
+        auto const inc_edges = tree.inc_edges(node);
+        auto const serial_inc_edges = serial_tree.inc_edges(node);
+        std::set<std::pair<int32_t, int32_t>> const edges(inc_edges.begin(), inc_edges.end());
+        std::set<std::pair<int32_t, int32_t>> const serial_edges(serial_inc_edges.begin(), serial_inc_edges.end());
+        ASSERT_EQ(edges, serial_edges);
+    }
+
+    graph::Graph<> contracted = graph::contract_to_n_nodes(graph, 40);
+    graph::Graph<> contracted_tree = graph::frt_tree(contracted);
+    auto const part = contracted_tree.partition(2, graph::Rational(1, 2));
+    std::vector<int32_t> contracted_part(part.second.cbegin(), part.second.cbegin() + contracted.node_cnt());
+    ASSERT_LE(contracted.partition_cost(contracted_part), part.first);
+}
+
+TEST(Graph, PartitionMultilevel) {
+    std::ifstream snap_file("resources/data_sets/email-Eu-core/email-Eu-core.txt");
+    graph::Graph<> graph = graphio::read_snap_graph<>(snap_file);
+    graph::Rational const imbalance(1, 2);
+    auto const result = graph::partition_multilevel(graph, 3, imbalance, 20, 0, 4);
+    ASSERT_EQ(result.second.size(), static_cast<size_t>(graph.node_cnt()));
+    ASSERT_EQ(result.first, graph.partition_cost(result.second));
+    ASSERT_FALSE(violates_balance(graph, result.second, 3, imbalance));
+
+    // The hub of a star must not absorb the leaves during the coarsening.
+    graph::Graph<> star(2000);
+    for (int32_t leaf = 1; leaf < star.node_cnt(); ++leaf) {
+        star.add_edge_weight(0, leaf, 1);
+    }
+    for (auto const& kparts_imbalance : {std::make_pair(2, graph::Rational(1, 3)),
+            std::make_pair(4, graph::Rational(1, 10))}) {
+        auto const star_result = graph::partition_multilevel(star, kparts_imbalance.first,
+                kparts_imbalance.second, 40, 0, 4);
+        ASSERT_EQ(star_result.first, star.partition_cost(star_result.second));
+        ASSERT_FALSE(violates_balance(star, star_result.second, kparts_imbalance.first, kparts_imbalance.second));
+    }
+
+    // A preferential attachment tree is coarsened to nodes of very different weights.
+    graph::Graph<> const tree = graphgen::TreePrefAttach<>(3000)(0);
+    auto const tree_result = graph::partition_multilevel(tree, 4, graph::Rational(1, 10), 40, 0, 4);
+    ASSERT_EQ(tree_result.first, tree.partition_cost(tree_result.second));
+    ASSERT_FALSE(violates_balance(tree, tree_result.second, 4, graph::Rational(1, 10)));
+}
+
+TEST(Graph, PartitionEvaluator) {
+    std::ifstream snap_file("resources/data_sets/email-Eu-core/email-Eu-core.txt");
+    graph::Graph<> graph = graphio::read_snap_graph<>(snap_file);
+    auto const csr_graph = graph.to_weighted_csr_graph(4);
+    std::vector<int32_t> partition;
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        partition.push_back(node % 4);
+    }
+    ASSERT_EQ(graph::cut_cost(csr_graph, partition, 4), graph.partition_cost(partition, 4));
+    ASSERT_EQ(graph.partition_cost(partition, 4), graph.partition_cost(partition, 1));
+
+    graph::PartitionEvaluator<int32_t, int32_t, int32_t> evaluator(csr_graph, partition, 4, 4);
+    ASSERT_EQ(evaluator.cut_cost(), graph.partition_cost(partition));
+    for (int32_t node = 0; node < graph.node_cnt(); node += 7) {
+        int32_t const target = (node / 7) % 4;
+        int32_t const delta = evaluator.move_delta(node, target);
+        int32_t const cut_before = evaluator.cut_cost();
+        ASSERT_EQ(evaluator.move(node, target), delta);
+        partition[node] = target;
+        ASSERT_EQ(evaluator.cut_cost(), cut_before + delta);
+    }
+    ASSERT_EQ(evaluator.partition(), partition);
+    ASSERT_EQ(evaluator.cut_cost(), graph.partition_cost(partition));
+
+    std::vector<int32_t> part_weights(4, 0);
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        part_weights[partition[node]] += graph.node_weight(node);
+    }
+    for (int32_t part = 0; part < 4; ++part) {
+        ASSERT_EQ(evaluator.part_weight(part), part_weights[part]);
+    }
+}
+
+TEST(Graph, RefinePartition) {
+    std::ifstream snap_file("resources/data_sets/email-Eu-core/email-Eu-core.txt");
+    graph::Graph<> graph = graphio::read_snap_graph<>(snap_file);
+    graph::Rational const imbalance(1, 10);
+    graph::PartitionResult<int32_t, int32_t> result;
+    for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+        result.second.push_back(node % 3);
+    }
+    int32_t const initial_cost = graph.partition_cost(result.second);
+    auto const rounds = graph::refine_partition(graph, result, 3, imbalance, std::chrono::milliseconds(10000), 4);
+    ASSERT_FALSE(rounds.empty());
+    ASSERT_EQ(rounds.front().cut_before, initial_cost);
+    for (size_t round_idx = 1; round_idx < rounds.size(); ++round_idx) {
+        ASSERT_EQ(rounds[round_idx].cut_before, rounds[round_idx - 1].cut_after);
+    }
+    ASSERT_EQ(result.first, graph.partition_cost(result.second));
+    ASSERT_LT(result.first, initial_cost);
+    ASSERT_FALSE(violates_balance(graph, result.second, 3, imbalance));
+}
+
+/**
+ * Decomposes a graph into a star whose center is connected to each node by an edge with the
+ * weighted degree of the node.
+ */
+struct StarDecomposer : public pipeline::IDecomposer<> {
+    graph::Graph<> operator()(graph::Graph<> const& graph) const override {
+        graph::Graph<> star(graph.node_cnt() + 1);
+        star.node_weight(graph.node_cnt(), 0);
+        for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+            int32_t degree = 0;
+            for (auto const& edge : graph.inc_edges(node)) {
+                degree += edge.second;
+            }
+            star.node_weight(node, graph.node_weight(node));
+            star.add_edge_weight(node, graph.node_cnt(), degree);
+        }
+        return star;
+    }
+};
+
+TEST(Graph, PipelineInMemory) {
+    std::stringstream snap_stream("# comment\n4 5\n10 7\n7 10\n\n3 3\n10 3\n3 10\n7 3\n");
+    std::stringstream text_stream;
+    graphio::convert_snap_format<>(snap_stream, text_stream, graphio::SnapConvertOptions());
+    snap_stream.clear();
+    snap_stream.seekg(0);
+    graph::Graph<> converted_graph;
+    text_stream >> converted_graph;
+    graph::Graph<> read_graph = graphio::read_snap_graph<>(snap_stream);
+    ASSERT_EQ(read_graph.node_cnt(), converted_graph.node_cnt());
+    ASSERT_EQ(read_graph.edge_cnt(), converted_graph.edge_cnt());
+    for (int32_t node = 0; node < read_graph.node_cnt(); ++node) {
+        auto const inc_edges = read_graph.inc_edges(node);
+        auto const converted_inc_edges = converted_graph.inc_edges(node);
+        std::set<std::pair<int32_t, int32_t>> const edges(inc_edges.begin(), inc_edges.end());
+        std::set<std::pair<int32_t, int32_t>> const converted_edges(
+                converted_inc_edges.begin(), converted_inc_edges.end());
+        ASSERT_EQ(edges, converted_edges);
+    }
+
+    std::string const file_name = "resources/data_sets/email-Eu-core/email-Eu-core.txt";
+    std::ifstream snap_file(file_name);
+    graph::Graph<> graph = graphio::read_snap_graph<>(snap_file);
+    snap_file.clear();
+    snap_file.seekg(0);
+
+    pipeline::PipelineOptions<> options(2, graph::Rational(1, 2), 40);
+    auto result = pipeline::Pipeline<>(options, std::make_shared<StarDecomposer>())(snap_file);
+    ASSERT_EQ(result.node_cnt, graph.node_cnt());
+    ASSERT_EQ(result.contracted_node_cnt, 40);
+    ASSERT_EQ(result.decomposed_node_cnt, 41);
+    ASSERT_EQ(result.partition.size(), static_cast<size_t>(graph.node_cnt()));
+    ASSERT_EQ(result.cut_cost, graph.partition_cost(result.partition));
+    ASSERT_EQ(result.total_weight, graph.node_cnt());
+    ASSERT_LE(result.max_part_weight, result.total_weight);
+    std::vector<std::string> stages;
+    for (auto const& timing : result.timings) {
+        stages.push_back(timing.stage);
+    }
+    ASSERT_EQ(stages, std::vector<std::string>({
+                "read", "contract", "decompose", "partition", "map back", "evaluate"}));
+}
+
+TEST(Graph, FromFileOnDemand) {
+    std::string const file_name = "from_file_on_demand.graph";
+    graph::Graph<> first_graph;
+    std::stringstream graph_stream("3 3 011\n1 1 1 2 2\n2 0 1 2 3\n2 0 2 1 3\n");
+    graph_stream >> first_graph;
+    graph::Graph<> second_graph(first_graph);
+    second_graph.contract_edges(graph::Graph<>::Matching({std::make_pair(0, 1)}));
+    {
+        std::ofstream file(file_name, std::ios::binary);
+        file << first_graph << "% comment\n" << graphio::WriteBinaryFormat<>(second_graph) << first_graph;
+    }
+
+    graphgen::FromFile<> eager_gen(file_name, 3);
+    for (bool do_prefetch : {false, true}) {
+        graphgen::FromFile<> on_demand_gen(file_name, 2, true, do_prefetch);
+        std::ifstream index_file(file_name + ".idx");
+        ASSERT_TRUE(index_file.good());
+        for (size_t seed : {0, 1, 2, 1, 2}) {
+            graph::Graph<> graph = on_demand_gen(seed);
+            graph::Graph<> eager_graph = eager_gen(seed);
+            ASSERT_EQ(graph.node_cnt(), eager_graph.node_cnt());
+            for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+                ASSERT_EQ(graph.node_weight(node), eager_graph.node_weight(node));
+                ASSERT_EQ(graph.node_repr(node), eager_graph.node_repr(node));
+                auto edges = graph.inc_edges(node);
+                auto eager_edges = eager_graph.inc_edges(node);
+                std::sort(edges.begin(), edges.end());
+                std::sort(eager_edges.begin(), eager_edges.end());
+                ASSERT_EQ(edges, eager_edges);
+            }
+        }
+    }
+    std::remove((file_name + ".idx").c_str());
+    std::remove(file_name.c_str());
+}
+
+TEST(Graph, FromFileOfPipe) {
+    std::string const fifo_name = "from_file_of_pipe.graph";
+    std::remove(fifo_name.c_str());
+    ASSERT_EQ(::mkfifo(fifo_name.c_str(), 0600), 0);
+    ASSERT_FALSE(fileutils::is_regular_file(fifo_name));
+
+    // Opening the pipe for writing blocks until it is opened for reading.
+    std::thread writer([&fifo_name](){
+            std::ofstream fifo(fifo_name);
+            fifo << "3 2 011\n1 1 4\n1 0 4 2 5\n1 1 5\n";
+            });
+    graphgen::FromFile<> graph_gen(fifo_name);
+    writer.join();
+    std::remove(fifo_name.c_str());
+
+    graph::Graph<> graph = graph_gen(0);
+    ASSERT_EQ(graph.node_cnt(), 3);
+    ASSERT_EQ(graph.edge_weight(0, 1), 4);
+    ASSERT_EQ(graph.edge_weight(1, 2), 5);
+}
+
 TEST(Graph, ContractEdges) {
     graph::Graph<> graph;
     std::stringstream graph_stream("3 3 011\n1 1 1 2 2\n2 0 1 2 3\n2 0 2 1 3\n"); 
@@ -98,6 +557,58 @@ TEST(Graph, ContractEdges) {
     ASSERT_EQ(graph.node_repr(1), graph::Graph<>::NodeSet({2}));
 }
 
+TEST(Graph, ContractInfEdgesLikeMatchings) {
+    using Graph = graph::Graph<>;
+    std::string const file_name =
+        "resources/data_sets/email-Eu-core/email-Eu-core_decomposed.graph";
+    std::shared_ptr<graphgen::IGraphGen<>> graph_gen(new graphgen::FromFile<>(file_name));
+    Graph contracted = graphgen::ContractInfEdges<>(graph_gen)();
+
+    // Contract infinite edges by repeatedly contracting matchings.
+    Graph expected = (*graph_gen)();
+    int32_t const infty = std::numeric_limits<int32_t>::max();
+    Graph::Matching matching;
+    do {
+        matching = Graph::Matching();
+        std::vector<bool> is_matched(expected.node_cnt());
+        for (int32_t node = 0; node < expected.node_cnt(); ++node) {
+            for (auto const& edge : expected.inc_edges(node)) {
+                if (edge.second == infty && !is_matched.at(node) && !is_matched.at(edge.first)) {
+                    matching.emplace_back(node, edge.first);
+                    is_matched[node] = true;
+                    is_matched[edge.first] = true;
+                }
+            }
+        }
+        expected.contract_edges(matching);
+    } while (matching.size() > 0);
+
+    ASSERT_EQ(contracted.node_cnt(), expected.node_cnt());
+    using NodeWithRepr = std::pair<Graph::NodeSet, int32_t>;
+    auto nodes_with_repr = [](Graph const& graph){
+        std::set<NodeWithRepr> nodes;
+        for (int32_t node = 0; node < graph.node_cnt(); ++node) {
+            nodes.emplace(graph.node_repr(node), graph.node_weight(node));
+        }
+        return nodes;
+    };
+    ASSERT_EQ(nodes_with_repr(contracted), nodes_with_repr(expected));
+
+    using EdgeWithRepr = std::tuple<Graph::NodeSet, Graph::NodeSet, int32_t>;
+    auto edges_with_repr = [](Graph const& graph){
+        std::set<EdgeWithRepr> edges;
+        for (auto const& edge : graph.edge_set()) {
+            edges.emplace(graph.node_repr(std::get<0>(edge)), graph.node_repr(std::get<1>(edge)),
+                    std::get<2>(edge));
+            edges.emplace(graph.node_repr(std::get<1>(edge)), graph.node_repr(std::get<0>(edge)),
+                    std::get<2>(edge));
+        }
+        return edges;
+    };
+    ASSERT_EQ(edges_with_repr(contracted), edges_with_repr(expected));
+    ASSERT_TRUE(contracted.is_tree());
+}
+
 // Metis sometimes violates the constraints because of rounding errors. Therefore this function checks
 // if metis violates the size constraint of the partitions.
 bool violates_max_part_size(std::vector<int> partition, int kparts, graph::Rational imbalance) {
@@ -218,6 +729,230 @@ TEST(GenGraph, CutCostForPartition) {
     delete graph_gen;
 }
 
+TEST(GenGraph, AutoRoot) {
+    graphgen::IGraphGen<>* graph_gen =
+        new graphgen::TreeFat<>(60, std::make_pair(2, 6));
+    for (size_t seed = 0; seed < 5; ++seed) {
+        graph::Graph<> graph = (*graph_gen)(seed);
+        auto const roots = graph.select_roots(3);
+        ASSERT_FALSE(roots.empty());
+        ASSERT_LE(roots.size(), 3u);
+        for (size_t root_idx = 1; root_idx < roots.size(); ++root_idx) {
+            ASSERT_LE(graph.to_tree(roots[root_idx - 1]).estimate_cut_work(),
+                    graph.to_tree(roots[root_idx]).estimate_cut_work());
+        }
+
+        auto const partition = graph.partition(2, cut::Rational(1,3));
+        auto const auto_partition = graph.partition_auto_root(2, cut::Rational(1,3), 3, 3);
+        ASSERT_EQ(auto_partition.first, partition.first);
+        ASSERT_EQ(auto_partition.first, graph.partition_cost(auto_partition.second));
+    }
+    delete graph_gen;
+
+    graph::Graph<> graph;
+    std::istringstream graph_stream("3 2 010\n2 1\n2 0 2\n2 1\n");
+    graph_stream >> graph;
+    std::atomic<bool> cancel(true);
+    cut::CutOptions options;
+    options.cancel = &cancel;
+    auto tree = graph.to_tree();
+    ASSERT_THROW(tree.cut(graph::Rational(1, 3), 2, options), cut::CutCancelledException);
+}
+
+TEST(GenGraph, ChainSignatures) {
+    graphgen::TreeRandAttach<> graph_gen(40, 2);
+    for (size_t seed = 0; seed < 5; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        auto chain_tree = graph.to_tree();
+        auto plain_tree = graph.to_tree();
+        cut::CutOptions chain_options;
+        chain_options.memoize_isomorphic = false;
+        cut::CutOptions plain_options;
+        plain_options.memoize_isomorphic = false;
+        plain_options.compress_chains = false;
+        auto const chain_sigs = chain_tree.cut(cut::Rational(1, 3), 3, chain_options);
+        auto const plain_sigs = plain_tree.cut(cut::Rational(1, 3), 3, plain_options);
+        for (size_t lvl_idx = 0; lvl_idx < plain_sigs.signatures.size(); ++lvl_idx) {
+            for (size_t node_idx = 0; node_idx < plain_sigs.signatures[lvl_idx].size(); ++node_idx) {
+                ASSERT_TRUE(equal_signatures(plain_sigs.signatures[lvl_idx][node_idx],
+                            chain_sigs.signatures[lvl_idx][node_idx]));
+            }
+        }
+
+        auto deleted_tree = graph.to_tree();
+        auto const deleted_sigs = deleted_tree.cut(cut::Rational(1, 3), 3, true);
+        ASSERT_TRUE(equal_signatures(plain_sigs.signatures[0][0], deleted_sigs.signatures[0][0]));
+    }
+}
+
+TEST(GenGraph, MemoizeIsomorphicForests) {
+    graphgen::TreeFat<> graph_gen(60, std::make_pair(2, 4), std::make_pair(1, 2), std::make_pair(1, 3));
+    for (size_t seed = 0; seed < 5; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        auto memo_tree = graph.to_tree();
+        auto plain_tree = graph.to_tree();
+        cut::CutStatistics statistics;
+        cut::CutOptions memo_options;
+        memo_options.statistics = &statistics;
+        cut::CutOptions plain_options;
+        plain_options.memoize_isomorphic = false;
+        auto const memo_sigs = memo_tree.cut(cut::Rational(1, 3), 2, memo_options);
+        auto const plain_sigs = plain_tree.cut(cut::Rational(1, 3), 2, plain_options);
+
+        ASSERT_EQ(statistics.node_cnt, static_cast<size_t>(graph.node_cnt() - 1));
+        ASSERT_GT(statistics.cache_hit_cnt, 0u);
+        ASSERT_LE(statistics.class_cnt + statistics.cache_hit_cnt, statistics.node_cnt);
+        for (size_t lvl_idx = 0; lvl_idx < plain_sigs.signatures.size(); ++lvl_idx) {
+            for (size_t node_idx = 0; node_idx < plain_sigs.signatures[lvl_idx].size(); ++node_idx) {
+                ASSERT_TRUE(equal_signatures(plain_sigs.signatures[lvl_idx][node_idx],
+                            memo_sigs.signatures[lvl_idx][node_idx]));
+            }
+        }
+
+        // With deleted signatures the nodes of a class share the cached map.
+        auto shared_tree = graph.to_tree();
+        cut::CutStatistics shared_statistics;
+        cut::CutOptions shared_options;
+        shared_options.delete_signatures = true;
+        shared_options.aggregate_leaf_runs = false;
+        shared_options.statistics = &shared_statistics;
+        auto const shared_sigs = shared_tree.cut(cut::Rational(1, 3), 2, shared_options);
+        ASSERT_EQ(shared_statistics.cache_hit_cnt, statistics.cache_hit_cnt);
+        ASSERT_TRUE(equal_signatures(plain_sigs.signatures[0][0], shared_sigs.signatures[0][0]));
+    }
+}
+
+TEST(GenGraph, AggregateLeafRuns) {
+    graphgen::TreePrefAttach<> graph_gen(50, 50, std::make_pair(1, 3), std::make_pair(1, 4));
+    for (size_t seed = 0; seed < 5; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        auto aggregated_tree = graph.to_tree();
+        auto plain_tree = graph.to_tree();
+        cut::CutStatistics statistics;
+        cut::CutOptions aggregated_options;
+        aggregated_options.delete_signatures = true;
+        aggregated_options.statistics = &statistics;
+        cut::CutOptions plain_options;
+        plain_options.delete_signatures = true;
+        plain_options.aggregate_leaf_runs = false;
+        auto const aggregated_sigs = aggregated_tree.cut(cut::Rational(1, 3), 3, aggregated_options);
+        auto const plain_sigs = plain_tree.cut(cut::Rational(1, 3), 3, plain_options);
+
+        ASSERT_EQ(statistics.node_cnt, static_cast<size_t>(graph.node_cnt() - 1));
+        ASSERT_GT(statistics.aggregated_leaf_cnt, 0u);
+        ASSERT_TRUE(equal_signatures(plain_sigs.signatures[0][0], aggregated_sigs.signatures[0][0]));
+        ASSERT_EQ(graph.partition(3, cut::Rational(1, 3)).first,
+                graph.partition_cost(graph.partition(3, cut::Rational(1, 3)).second));
+    }
+}
+
+TEST(GenGraph, CutBound) {
+    graphgen::TreeFat<> graph_gen(60, std::make_pair(2, 4), std::make_pair(1, 3), std::make_pair(1, 10));
+    for (size_t seed = 0; seed < 5; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        auto const greedy_result = graph.partition_greedy(3, cut::Rational(1, 3));
+        ASSERT_FALSE(violates_balance(graph, greedy_result.second, 3, cut::Rational(1, 3)));
+        ASSERT_EQ(greedy_result.first, graph.partition_cost(greedy_result.second));
+
+        auto const result = graph.partition(3, cut::Rational(1, 3));
+        auto const bounded_result = graph.partition_bounded(3, cut::Rational(1, 3));
+        ASSERT_EQ(std::min(result.first, greedy_result.first), bounded_result.first);
+        ASSERT_EQ(result.first, graph.partition_with_bound(3, cut::Rational(1, 3), result.first).first);
+        if (result.first > 0) {
+            ASSERT_THROW(graph.partition_with_bound(3, cut::Rational(1, 3), result.first - 1),
+                    part::PartitionException);
+        }
+    }
+}
+
+TEST(GenGraph, PruneUnpackable) {
+    graphgen::TreeFat<> graph_gen(40, std::make_pair(2, 4), std::make_pair(1, 3), std::make_pair(1, 10));
+    for (size_t seed = 0; seed < 2; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        auto pruned_tree = graph.to_tree();
+        auto plain_tree = graph.to_tree();
+        cut::CutStatistics statistics;
+        cut::CutOptions pruned_options;
+        pruned_options.prune_unpackable = true;
+        pruned_options.statistics = &statistics;
+        auto const pruned_sigs = pruned_tree.cut(cut::Rational(1, 3), 6, pruned_options);
+        auto const plain_sigs = plain_tree.cut(cut::Rational(1, 3), 6, cut::CutOptions());
+
+        ASSERT_GT(statistics.packing_pruned_cnt, 0u);
+        auto const tree_weight = plain_tree.subtree_weight[0][0];
+        auto const& pruned_root_sigs = pruned_sigs.signatures[0][0].at(tree_weight);
+        auto const& plain_root_sigs = plain_sigs.signatures[0][0].at(tree_weight);
+        ASSERT_LT(pruned_root_sigs.size(), plain_root_sigs.size());
+        for (auto const& sig : pruned_root_sigs) {
+            ASSERT_EQ(plain_root_sigs.at(sig.first), sig.second);
+        }
+        ASSERT_EQ(std::get<2>(part::calculate_best_packing(plain_sigs)),
+                std::get<2>(part::calculate_best_packing(pruned_sigs)));
+    }
+}
+
+TEST(GenGraph, BeamSearch) {
+    graphgen::TreeFat<> graph_gen(60, std::make_pair(2, 4), std::make_pair(1, 3), std::make_pair(1, 10));
+    for (size_t seed = 0; seed < 3; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        cut::CutStatistics statistics;
+        auto const exact_result = graph.partition(3, cut::Rational(1, 3));
+        auto const beam_result = graph.partition(3, cut::Rational(1, 3), 0, &statistics, 4);
+        ASSERT_GT(statistics.beam_dropped_cnt, 0u);
+        ASSERT_GE(beam_result.first, exact_result.first);
+        ASSERT_FALSE(violates_balance(graph, beam_result.second, 3, cut::Rational(1, 3)));
+
+        auto const wide_beam_result = graph.partition(3, cut::Rational(1, 3), 0, nullptr,
+                std::numeric_limits<size_t>::max());
+        ASSERT_EQ(exact_result.first, wide_beam_result.first);
+    }
+}
+
+TEST(GenGraph, CoarsenedWeights) {
+    graphgen::TreeFat<> graph_gen(20, std::make_pair(2, 4), std::make_pair(100, 300), std::make_pair(1, 10));
+    for (size_t seed = 0; seed < 3; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        auto const tree = graph.to_tree();
+        auto const coarsened_tree = tree.coarsen_weights(20);
+        ASSERT_LE(coarsened_tree.subtree_weight[0][0], tree.subtree_weight[0][0] / 20 + graph.node_cnt());
+
+        auto const exact_result = graph.partition(3, cut::Rational(1, 2));
+        auto const coarsened_result = graph.partition_coarsened(3, cut::Rational(1, 2), 20);
+        ASSERT_GE(coarsened_result.first, exact_result.first);
+        ASSERT_FALSE(violates_balance(graph, coarsened_result.second, 3, cut::Rational(1, 2)));
+
+        ASSERT_THROW(graph.partition_coarsened(3, cut::Rational(1, 2), tree.subtree_weight[0][0]),
+                std::invalid_argument);
+    }
+}
+
+TEST(GenGraph, ScaledWeights) {
+    graphgen::TreeFat<> graph_gen(40, std::make_pair(2, 4), std::make_pair(100, 300), std::make_pair(1, 10));
+    for (size_t seed = 0; seed < 3; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+        cut::CutStatistics statistics;
+        auto result = graph.partition_scaled(3, cut::Rational(1, 3), 200, 0, &statistics);
+        ASSERT_EQ(statistics.node_cnt, static_cast<size_t>(graph.node_cnt() - 1));
+
+        bool const is_balanced = graph.partition_imbalance(result.second, 3) <= cut::Rational(1, 3);
+        ASSERT_EQ(graph::rebalance_partition(graph, result, 3, cut::Rational(1, 3)) == 0, is_balanced);
+        ASSERT_LE(graph.partition_imbalance(result.second, 3), cut::Rational(1, 3));
+        ASSERT_EQ(result.first, graph.partition_cost(result.second));
+
+        ASSERT_THROW(graph.partition_scaled(3, cut::Rational(1, 3), 2), std::invalid_argument);
+
+        graph::PartitionResult<int32_t, int32_t> skewed_result(0, std::vector<int32_t>(graph.node_cnt(), 0));
+        ASSERT_GT(graph::rebalance_partition(graph, skewed_result, 3, cut::Rational(1, 3)), 0u);
+        ASSERT_LE(graph.partition_imbalance(skewed_result.second, 3), cut::Rational(1, 3));
+        ASSERT_EQ(skewed_result.first, graph.partition_cost(skewed_result.second));
+    }
+
+    graph::Graph<> light_graph = graphgen::TreeFat<>(30, std::make_pair(2, 4), std::make_pair(1, 3),
+            std::make_pair(1, 10))(0);
+    ASSERT_EQ(light_graph.partition_scaled(3, cut::Rational(1, 3), 1000).first,
+            light_graph.partition(3, cut::Rational(1, 3)).first);
+}
+
 TEST(GenGraph, Mst) {
     std::shared_ptr<graphgen::IGraphGen<>>
         graph_gen(new graphgen::GraphEdgeProb<>(30, 0.5));
@@ -236,6 +971,86 @@ TEST(GenGraph, Rst) {
     ASSERT_EQ(graph.node_cnt(), 30);
 }
 
+int32_t spanning_tree_weight(graph::Graph<> const& tree) {
+    int32_t weight = 0;
+    for (auto const& edge : tree.edge_set()) {
+        weight += std::get<2>(edge);
+    }
+    return weight;
+}
+
+TEST(Graph, MstEqualsKruskal) {
+    graphgen::GraphEdgeProb<> graph_gen(80, 0.2, std::numeric_limits<int32_t>::max(),
+            std::make_pair(1, 2), std::make_pair(1, 5));
+    for (size_t seed = 0; seed < 10; ++seed) {
+        graph::Graph<> graph = graph_gen(seed);
+
+        auto edges = graph.edge_set();
+        std::sort(edges.begin(), edges.end(), [](graph::Graph<>::Edge const& one, graph::Graph<>::Edge const& other){
+                return std::make_tuple(std::get<2>(one), std::get<0>(one), std::get<1>(one)) <
+                    std::make_tuple(std::get<2>(other), std::get<0>(other), std::get<1>(other));
+                });
+        graph::UnionFind<int32_t> union_find(graph.node_cnt());
+        int32_t kruskal_weight = 0;
+        for (auto const& edge : edges) {
+            if (union_find.find(std::get<0>(edge)) != union_find.find(std::get<1>(edge))) {
+                union_find.union_(std::get<0>(edge), std::get<1>(edge));
+                kruskal_weight += std::get<2>(edge);
+            }
+        }
+
+        for (size_t thread_cnt : {1, 4}) {
+            graph::Graph<> mst = graph::mst(graph, thread_cnt);
+            ASSERT_TRUE(mst.is_tree());
+            ASSERT_EQ(mst.edge_cnt(), graph.node_cnt() - 1);
+            ASSERT_EQ(spanning_tree_weight(mst), kruskal_weight);
+        }
+    }
+}
+
+TEST(Graph, RstOfDisconnectedGraph) {
+    graph::Graph<> graph;
+    std::stringstream graph_stream(
+            "6 5 011\n2 1 1 2 3\n1 0 1 2 2\n1 0 3 1 2\n1 4 4\n1 3 4 5 1\n1 4 1\n");
+    graph_stream >> graph;
+
+    graph::Graph<> rst = graph::rst(graph, 3);
+    ASSERT_TRUE(rst.is_tree());
+    ASSERT_EQ(rst.edge_cnt(), 5);
+    ASSERT_EQ(rst.node_weight(0), 2);
+
+    size_t patch_edge_cnt = 0;
+    for (auto const& edge : rst.edge_set()) {
+        if (graph.exists_edge(std::get<0>(edge), std::get<1>(edge))) {
+            ASSERT_EQ(graph.edge_weight(std::get<0>(edge), std::get<1>(edge)), std::get<2>(edge));
+        } else {
+            ASSERT_EQ(std::get<2>(edge), 0);
+            patch_edge_cnt += 1;
+        }
+    }
+    ASSERT_EQ(patch_edge_cnt, 1);
+    ASSERT_EQ(graph::rst(graph, 3, 1).edge_set(), rst.edge_set());
+}
+
+TEST(Graph, RstEnsemble) {
+    graphgen::GraphPrefAttach<> graph_gen(60, 3);
+    graph::Graph<> graph = graph_gen(0);
+
+    auto ensemble_res = graph::partition_rst_ensemble(graph, 3, graph::Rational(1, 3), 6, 0, 3);
+    ASSERT_EQ(ensemble_res.tree_stats.size(), 6);
+    ASSERT_EQ(ensemble_res.best.first, graph.partition_cost(ensemble_res.best.second));
+    for (auto const& stats : ensemble_res.tree_stats) {
+        ASSERT_TRUE(stats.is_feasible);
+        ASSERT_LE(ensemble_res.best.first, stats.graph_cut_cost);
+        ASSERT_LE(stats.tree_cut_cost, stats.graph_cut_cost);
+    }
+    ASSERT_EQ(ensemble_res.tree_stats.at(ensemble_res.best_tree_idx).graph_cut_cost,
+            ensemble_res.best.first);
+
+    auto serial_res = graph::partition_rst_ensemble(graph, 3, graph::Rational(1, 3), 6, 0, 1);
+    ASSERT_EQ(serial_res.best, ensemble_res.best);
+}
+
 TEST(GenGraph, Contract) {
     std::shared_ptr<graphgen::IGraphGen<>>
         graph_gen(new graphgen::TreeRandAttach<>(60));
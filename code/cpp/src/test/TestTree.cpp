@@ -1,6 +1,7 @@
 #include<cstdint>
 #include<map>
 #include<iostream>
+#include<sstream>
 
 #include<gtest/gtest.h>
 
@@ -101,3 +102,60 @@ TEST(BuildTree, ThreeNodes) {
     ASSERT_EQ(tree.subtree_weight[1][0], 1);
     ASSERT_EQ(tree.subtree_weight[1][1], 1);
 }
+
+TEST(BuildTree, ChildrenBySubtreeWeight) {
+    std::map<int, std::map<int, int>> tree_map;
+    std::map<int, int> node_weight({{1, 1}, {2, 1}, {3, 1}, {4, 1}, {5, 1}});
+    tree_map[1][2] = 1;
+    tree_map[2][1] = 1;
+    tree_map[1][3] = 1;
+    tree_map[3][1] = 1;
+    tree_map[2][4] = 1;
+    tree_map[4][2] = 1;
+    tree_map[2][5] = 1;
+    tree_map[5][2] = 1;
+
+    Tree by_id = Tree::build_tree(tree_map, node_weight, 1);
+    ASSERT_EQ(by_id.levels[1][0].id, 2);
+    ASSERT_EQ(by_id.levels[1][1].id, 3);
+
+    Tree by_weight = Tree::build_tree(tree_map, node_weight, 1, cut::ChildOrder::BY_SUBTREE_WEIGHT);
+    ASSERT_EQ(by_weight.levels[1][0].id, 3);
+    ASSERT_EQ(by_weight.levels[1][1].id, 2);
+    ASSERT_EQ(by_weight.subtree_weight[1][0], 1);
+    ASSERT_EQ(by_weight.subtree_weight[1][1], 3);
+    ASSERT_TRUE(by_weight.has_left_sibling[1][1]);
+    ASSERT_EQ(by_weight.levels[2].size(), 2u);
+    ASSERT_EQ(by_weight.levels[2][0].parent_idx, 1u);
+    ASSERT_LE(by_weight.estimate_cut_work(), by_id.estimate_cut_work());
+}
+
+TEST(BuildTree, StreamNodeWeights) {
+    std::map<int, std::map<int, int>> tree_map;
+    std::map<int, int> node_weight({{1, 1000}, {2, 250}, {3, 1}});
+    tree_map[1][2] = 4;
+    tree_map[2][1] = 4;
+    tree_map[1][3] = 2;
+    tree_map[3][1] = 2;
+    Tree tree = Tree::build_tree(tree_map, node_weight, 1);
+
+    std::stringstream stream;
+    stream << tree;
+    Tree read_tree;
+    stream >> read_tree;
+    ASSERT_EQ(read_tree.subtree_weight[0][0], 1251);
+    ASSERT_EQ(read_tree.levels[1][0].weight, 250);
+    ASSERT_EQ(read_tree.levels[1][1].parent_edge_weight, 2);
+
+    std::stringstream unit_stream("3 1\n1 2 4\n1 3 2\n");
+    Tree unit_tree;
+    unit_stream >> unit_tree;
+    ASSERT_EQ(unit_tree.subtree_weight[0][0], 3);
+
+    Tree scaled_tree = tree.scale_weights(cut::Rational(1, 100));
+    ASSERT_EQ(scaled_tree.levels[0][0].weight, 10);
+    ASSERT_EQ(scaled_tree.levels[1][0].weight, 3);
+    // The light node keeps weight one instead of being rounded to zero.
+    ASSERT_EQ(scaled_tree.levels[1][1].weight, 1);
+    ASSERT_EQ(scaled_tree.subtree_weight[0][0], 14);
+}